@@ -72,6 +72,23 @@ solution "Examples"
 		files { examplesPath .. "/TestFS/**.h", examplesPath .. "/TestFS/**.inl", examplesPath .. "/TestFS/**.cpp", examplesPath .. "/Shared/User.cpp" }
 		objdir( objectDir .. "/Examples/TestFS" )
 
+	-- TestBenchmark Executable
+	project "TestBenchmark"
+		uuid "658F23FB-25CB-4C45-99F3-4D656169DD03"
+		kind "ConsoleApp"
+		language "C++"
+		targetdir( binaryDir )
+		includedirs { librariesPath .. "/Include" }
+		links { "ogShared", "ogCommon", "liblfds" }
+		if isWindows then
+			links { "winmm" }
+		end
+		if isLinux then
+			links{ "boost_thread" }
+		end
+		files { examplesPath .. "/TestBenchmark/**.h", examplesPath .. "/TestBenchmark/**.cpp", examplesPath .. "/Shared/User.cpp" }
+		objdir( objectDir .. "/Examples/TestBenchmark" )
+
 	-- TestGloot Executable
 	project "TestGloot"
 		uuid "0A6C6FD3-97EC-4B49-8958-31AF782C07D7"
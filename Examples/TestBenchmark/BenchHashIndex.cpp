@@ -0,0 +1,191 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: HashIndex benchmarks
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include "Benchmark.h"
+
+const int HASH_NUM_FILES	= 100000;	// like the central directory of a big pak file
+const int HASH_NUM_REMOVES	= 200;		// shifting removes touch every entry, so only a few
+
+/*
+==============================================================================
+
+  ChainedIndex
+
+  The previous HashIndex: a fixed number of buckets with a heap node per entry.
+
+==============================================================================
+*/
+class ChainedIndex {
+public:
+	ChainedIndex( int size ) : mask(size - 1) {
+		buckets = new Node *[size];
+		memset( buckets, 0, sizeof(Node *) * size );
+	}
+	~ChainedIndex() {
+		for( int i=0; i<=mask; i++ ) {
+			while( buckets[i] ) {
+				Node *next = buckets[i]->next;
+				delete buckets[i];
+				buckets[i] = next;
+			}
+		}
+		delete[] buckets;
+	}
+
+	void Add( int hash, int index ) {
+		Node *node = new Node;
+		node->index = index;
+		node->next = buckets[hash & mask];
+		buckets[hash & mask] = node;
+	}
+
+	int First( int hash ) const {
+		findNode = buckets[hash & mask];
+		return findNode ? findNode->index : -1;
+	}
+
+	int Next( void ) const {
+		findNode = findNode->next;
+		return findNode ? findNode->index : -1;
+	}
+
+private:
+	struct Node {
+		Node *	next;
+		int		index;
+	};
+	Node **			buckets;
+	int				mask;
+	mutable Node *	findNode;
+};
+
+/*
+================
+FindName
+================
+*/
+template<class IndexType>
+static int FindName( const IndexType &index, const og::List<og::String> &names, const char *name, int hash ) {
+	for( int i=index.First( hash ); i != -1; i=index.Next() ) {
+		if ( names[i].Icmp( name ) == 0 )
+			return i;
+	}
+	return -1;
+}
+
+/*
+================
+BenchLookups
+================
+*/
+template<class IndexType>
+static void BenchLookups( const char *name, const IndexType &index, const og::List<og::String> &names, const og::List<og::String> &missing, const og::List<int> &hashes, const og::List<int> &missingHashes ) {
+	og::String label;
+	int found = 0;
+	BenchTimer timer;
+	for( int i=0; i<HASH_NUM_FILES; i++ )
+		found += FindName( index, names, names[i].c_str(), hashes[i] ) == i;
+	label = og::Format( "$* hits" ) << name;
+	PrintResult( label.c_str(), HASH_NUM_FILES, timer.GetMicroseconds() );
+	if ( found != HASH_NUM_FILES )
+		printf( "  error: found only %d of %d\n", found, HASH_NUM_FILES );
+
+	found = 0;
+	timer.Start();
+	for( int i=0; i<HASH_NUM_FILES; i++ )
+		found += FindName( index, names, missing[i].c_str(), missingHashes[i] ) != -1;
+	label = og::Format( "$* misses" ) << name;
+	PrintResult( label.c_str(), HASH_NUM_FILES, timer.GetMicroseconds() );
+	if ( found != 0 )
+		printf( "  error: found %d missing files\n", found );
+}
+
+/*
+================
+BenchHashIndex
+================
+*/
+void BenchHashIndex( void ) {
+	og::List<og::String> names, missing;
+	og::List<int> hashes, missingHashes;
+	for( int i=0; i<HASH_NUM_FILES; i++ ) {
+		names.Alloc() = og::Format( "textures/set$*/tile_$*.tga" ) << (i / 100) << i;
+		missing.Alloc() = og::Format( "sounds/set$*/missing_$*.ogg" ) << (i / 100) << i;
+		hashes.Append( og::HashIndex::GenerateKey( names[i].c_str(), false ) );
+		missingHashes.Append( og::HashIndex::GenerateKey( missing[i].c_str(), false ) );
+	}
+
+	{
+		BenchTimer timer;
+		ChainedIndex index( 128 );
+		for( int i=0; i<HASH_NUM_FILES; i++ )
+			index.Add( hashes[i], i );
+		PrintResult( "chained, 128 buckets: add", HASH_NUM_FILES, timer.GetMicroseconds() );
+		BenchLookups( "chained, 128 buckets:", index, names, missing, hashes, missingHashes );
+	}
+	{
+		BenchTimer timer;
+		ChainedIndex index( 131072 );
+		for( int i=0; i<HASH_NUM_FILES; i++ )
+			index.Add( hashes[i], i );
+		PrintResult( "chained, 128k buckets: add", HASH_NUM_FILES, timer.GetMicroseconds() );
+		BenchLookups( "chained, 128k buckets:", index, names, missing, hashes, missingHashes );
+	}
+	{
+		BenchTimer timer;
+		og::HashIndex index;
+		for( int i=0; i<HASH_NUM_FILES; i++ )
+			index.Add( hashes[i], i );
+		PrintResult( "HashIndex: add ( growing from 128 )", HASH_NUM_FILES, timer.GetMicroseconds() );
+		BenchLookups( "HashIndex:", index, names, missing, hashes, missingHashes );
+
+		// remove from the end like a List would, shifting every index above
+		timer.Start();
+		for( int i=0; i<HASH_NUM_REMOVES; i++ )
+			index.Remove( hashes[i * 50], i * 50 - i );
+		PrintResult( "HashIndex: remove, shifting indices", HASH_NUM_REMOVES, timer.GetMicroseconds() );
+	}
+	{
+		og::HashIndex index;
+		for( int i=0; i<HASH_NUM_FILES; i++ )
+			index.Add( hashes[i], i );
+
+		// swap the last entry into the gap, like a slot map would
+		BenchTimer timer;
+		for( int last=HASH_NUM_FILES-1; last>0; last-- ) {
+			int i = last / 2;
+			index.Remove( hashes[i], i, false );
+			index.Reindex( hashes[last], last, i );
+			hashes[i] = hashes[last];
+		}
+		PrintResult( "HashIndex: remove, swapping in the last", HASH_NUM_FILES - 1, timer.GetMicroseconds() );
+		if ( index.Num() != 1 )
+			printf( "  error: %d entries left\n", index.Num() );
+	}
+}
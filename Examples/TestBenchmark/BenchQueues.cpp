@@ -0,0 +1,143 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Queue benchmarks
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include "Benchmark.h"
+#include <og/Common/Thread/LockFreeQueue.h>
+#include <og/Common/Thread/RingQueue.h>
+
+const int QUEUE_OPS = 1000000;
+
+struct QueueItem {
+	int value;
+};
+static QueueItem items[1024];
+
+/*
+==============================================================================
+
+  ProducerThread
+
+==============================================================================
+*/
+template<class QueueType>
+class ProducerThread : public BenchThread {
+public:
+	ProducerThread( og::AtomicInt *numDone, QueueType *_queue, int _count ) : BenchThread(numDone), queue(_queue), count(_count) {}
+
+protected:
+	void Work( void ) {
+		for( int i=0; i<count; i++ ) {
+			while( !queue->Produce( &items[i & 1023] ) )
+				og::Sleep( 0 );
+		}
+	}
+
+private:
+	QueueType *	queue;
+	int			count;
+};
+
+struct CountItem {
+	int *counter;
+	void operator()( QueueItem * ) { (*counter)++; }
+};
+
+/*
+================
+RunQueue
+
+Runs numProducers producer threads, the calling thread consumes
+================
+*/
+template<class QueueType>
+void RunQueue( const char *name, QueueType &queue, int numProducers, bool batched ) {
+	og::AtomicInt numDone;
+	int perProducer = QUEUE_OPS / numProducers;
+	int total = perProducer * numProducers;
+
+	BenchTimer timer;
+	ProducerThread<QueueType> *threads[8];
+	for( int i=0; i<numProducers; i++ ) {
+		threads[i] = new ProducerThread<QueueType>( &numDone, &queue, perProducer );
+		threads[i]->Start( "Producer" );
+	}
+
+	int consumed = 0;
+	if ( batched ) {
+		CountItem counter = { &consumed };
+		while( consumed < total ) {
+			if ( queue.ConsumeAll( counter ) == 0 )
+				og::Sleep( 0 );
+		}
+	} else {
+		while( consumed < total ) {
+			if ( queue.Consume() != NULL )
+				consumed++;
+			else
+				og::Sleep( 0 );
+		}
+	}
+	PrintResult( name, total, timer.GetMicroseconds() );
+
+	for( int i=0; i<numProducers; i++ )
+		threads[i]->Stop( true );
+}
+
+/*
+================
+BenchQueues
+================
+*/
+void BenchQueues( void ) {
+	for( int numProducers=1; numProducers<=4; numProducers *= 2 ) {
+		printf( " %d producer(s), 1 consumer:\n", numProducers );
+		{
+			og::LockFreeQueue<QueueItem> queue;
+			RunQueue( "LockFreeQueue (liblfds)", queue, numProducers, false );
+		}
+		{
+			og::MpscQueue<QueueItem> queue;
+			RunQueue( "MpscQueue", queue, numProducers, false );
+		}
+		{
+			og::MpscQueue<QueueItem> queue;
+			RunQueue( "MpscQueue ConsumeAll", queue, numProducers, true );
+		}
+		if ( numProducers == 1 ) {
+			{
+				og::SpscQueue<QueueItem> queue;
+				RunQueue( "SpscQueue", queue, numProducers, false );
+			}
+			{
+				og::SpscQueue<QueueItem> queue;
+				RunQueue( "SpscQueue ConsumeAll", queue, numProducers, true );
+			}
+		}
+	}
+}
@@ -0,0 +1,145 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: SharedMutex benchmarks
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include "Benchmark.h"
+
+const int MUTEX_READS = 400000;
+const int MUTEX_WRITE_INTERVAL = 1;	// ms between two exclusive locks
+
+/*
+==============================================================================
+
+  FakeFileSystem
+
+  Mimics FileSystemEx: every open takes a shared lock to read the search paths,
+  ChangeMod takes the exclusive lock to replace them.
+
+==============================================================================
+*/
+class FakeFileSystem {
+public:
+	FakeFileSystem( bool striped ) : mutex(striped), modDir(0), modDirCheck(0), numErrors(0) {}
+
+	void OpenRead( int file ) {
+		og::SharedLock lock(mutex);
+		int dir = modDir;
+		// some work, like building the path
+		uInt hash = static_cast<uInt>( dir );
+		for( int i=0; i<16; i++ )
+			hash = hash * 31 + static_cast<uInt>( file + i );
+		sink = hash;
+		if ( dir != modDirCheck )
+			numErrors.Increment();
+	}
+
+	void ChangeMod( void ) {
+		mutex.lock();
+		modDir++;
+		og::CompilerFence();
+		modDirCheck = modDir;
+		mutex.unlock();
+	}
+
+	int GetNumErrors( void ) { return numErrors.Get(); }
+
+private:
+	og::SharedMutex	mutex;
+	volatile int	modDir;
+	volatile int	modDirCheck;
+	volatile uInt	sink;
+	og::AtomicInt	numErrors;
+};
+
+/*
+==============================================================================
+
+  ReaderThread
+
+==============================================================================
+*/
+class ReaderThread : public BenchThread {
+public:
+	ReaderThread( og::AtomicInt *numDone, FakeFileSystem *_fs, int _count ) : BenchThread(numDone), fs(_fs), count(_count) {}
+
+protected:
+	void Work( void ) {
+		for( int i=0; i<count; i++ )
+			fs->OpenRead( i );
+	}
+
+private:
+	FakeFileSystem *fs;
+	int				count;
+};
+
+/*
+================
+RunSharedMutex
+
+Runs numReaders reader threads, the calling thread changes the mod now and then
+================
+*/
+void RunSharedMutex( const char *name, bool striped, int numReaders ) {
+	FakeFileSystem fs( striped );
+	og::AtomicInt numDone;
+	int perReader = MUTEX_READS / numReaders;
+
+	BenchTimer timer;
+	ReaderThread *threads[8];
+	for( int i=0; i<numReaders; i++ ) {
+		threads[i] = new ReaderThread( &numDone, &fs, perReader );
+		threads[i]->Start( "Reader" );
+	}
+
+	int numWrites = 0;
+	while( numDone.Get() < numReaders ) {
+		og::Sleep( MUTEX_WRITE_INTERVAL );
+		fs.ChangeMod();
+		numWrites++;
+	}
+	PrintResult( name, perReader * numReaders, timer.GetMicroseconds() );
+	if ( fs.GetNumErrors() )
+		printf( "  ERROR: %d reads saw a half done write\n", fs.GetNumErrors() );
+
+	for( int i=0; i<numReaders; i++ )
+		threads[i]->Stop( true );
+}
+
+/*
+================
+BenchSharedMutex
+================
+*/
+void BenchSharedMutex( void ) {
+	for( int numReaders=1; numReaders<=8; numReaders *= 2 ) {
+		printf( " %d reader(s), 1 writer:\n", numReaders );
+		RunSharedMutex( "SharedMutex", false, numReaders );
+		RunSharedMutex( "SharedMutex striped", true, numReaders );
+	}
+}
@@ -0,0 +1,274 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: String benchmarks
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include "Benchmark.h"
+
+const int STRING_NUM_DECLS	= 2000;	// entity decls, each one a block of key/value lines
+const int STRING_NUM_RUNS	= 20;	// passes over the whole text, so the timings get stable
+
+/*
+==============================================================================
+
+  Byte by byte versions, like String had them before
+
+==============================================================================
+*/
+static void OldBothLengths( const char *text, size_t *byteLength, size_t *length ) {
+	*byteLength = 0;
+	*length = 0;
+	for( ; text[*byteLength] != '\0'; (*byteLength)++ ) {
+		if( (text[*byteLength] & 0xC0) != 0x80 )
+			(*length)++;
+	}
+}
+
+static int OldLowerChar( const char *text, int *numBytes ) {
+	byte c = static_cast<byte>(text[0]);
+	if ( c < 0x80 ) {
+		*numBytes = 1;
+		return tolower( c );
+	} else if ( (c & 0xE0) == 0xC0 ) {
+		*numBytes = 2;
+		return towlower( ((c & 0x1F) << 6) | (text[1] & 0x3F) );
+	} else if ( (c & 0xF0) == 0xE0 ) {
+		*numBytes = 3;
+		return towlower( ((c & 0x0F) << 12) | ((text[1] & 0x3F) << 6) | (text[2] & 0x3F) );
+	}
+	*numBytes = 1;
+	return c;
+}
+
+static int OldIcmp( const char *text1, const char *text2 ) {
+	int numB1, numB2, d;
+	for( int i=0, j=0; text1[i] || text2[j]; i += numB1, j += numB2 ) {
+		d = OldLowerChar( text1+i, &numB1 ) - OldLowerChar( text2+j, &numB2 );
+		if ( d != 0 )
+			return d;
+	}
+	return 0;
+}
+
+static int OldFind( const char *str, const char *text ) {
+	int findLen = static_cast<int>( og::String::Length( text ) );
+	for( int i=0; str[i] != 0; i++ ) {
+		if ( og::String::Cmpn( str+i, text, findLen ) == 0 )
+			return i;
+	}
+	return -1;
+}
+
+static int OldFindOneOf( const char *str, const char *text ) {
+	for( int i=0; str[i] != 0; i++ ) {
+		for( int j=0; text[j] != 0; j++ ) {
+			if ( str[i] == text[j] )
+				return i;
+		}
+	}
+	return -1;
+}
+
+static size_t OldStripEscapeColor( char *str ) {
+	int escapeLength, skip = 0;
+	char *writePos = str;
+	char *readPos = str;
+	for( ; *readPos != '\0'; readPos++ ) {
+		if ( skip )
+			skip--;
+		else {
+			escapeLength = og::String::GetEscapeColorLength( readPos );
+			if ( escapeLength )
+				skip = escapeLength-1;
+			else
+				*writePos++ = *readPos;
+		}
+	}
+	*writePos = '\0';
+	return readPos - writePos;
+}
+
+// Called through volatile pointers, so the compiler can't move them out of the run loops.
+// The String functions live in another library, so they get called every time anyway.
+static void		(* volatile oldBothLengths)( const char *, size_t *, size_t * ) = OldBothLengths;
+static int		(* volatile oldIcmp)( const char *, const char * ) = OldIcmp;
+static int		(* volatile oldFind)( const char *, const char * ) = OldFind;
+static int		(* volatile oldFindOneOf)( const char *, const char * ) = OldFindOneOf;
+static size_t	(* volatile oldStripEscapeColor)( char * ) = OldStripEscapeColor;
+
+/*
+================
+BuildDeclText
+
+Entity decls like a game would parse them, with some colored and non-ascii names
+================
+*/
+static void BuildDeclText( og::List<og::String> &lines, og::List<og::String> &keys ) {
+	for( int i=0; i<STRING_NUM_DECLS; i++ ) {
+		lines.Alloc() = og::Format( "entityDef monster_$*_$* {" ) << (i % 3 == 0 ? "zombie" : "imp") << i;
+		lines.Alloc() = og::Format( "\t\"inherit\"\t\t\t\"monster_base_$*\"" ) << (i % 7);
+		lines.Alloc() = og::Format( "\t\"model\"\t\t\t\t\"models/monsters/imp/imp_$*.md5mesh\"" ) << i;
+		lines.Alloc() = "\t\"editor_usage\"\t\t\"Spawns a ^1hostile^7 monster, which attacks the player on sight\"";
+		lines.Alloc() = og::Format( "\t\"name\"\t\t\t\t\"^c0F0Gr\xC3\xBCnling ^7der Schreckliche $*\"" ) << i;
+		lines.Alloc() = og::Format( "\t\"health\"\t\t\t\"$*\"" ) << (100 + i % 50);
+		lines.Alloc() = og::Format( "\t\"snd_sight\"\t\t\t\"sound/monsters/imp/sight_$*.ogg\"" ) << (i % 4);
+		lines.Alloc() = "}";
+	}
+	keys.Append( "ENTITYDEF" );
+	keys.Append( "Editor_Usage" );
+	keys.Append( "MODEL" );
+	keys.Append( "snd_sight" );
+}
+
+/*
+================
+BenchString
+================
+*/
+void BenchString( void ) {
+	og::List<og::String> lines, keys;
+	BuildDeclText( lines, keys );
+	int numLines = lines.Num();
+	int numOps = numLines * STRING_NUM_RUNS;
+	size_t byteLen, len, total;
+
+	BenchTimer timer;
+	total = 0;
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ ) {
+			oldBothLengths( lines[i].c_str(), &byteLen, &len );
+			total += len;
+		}
+	}
+	PrintResult( "lengths: byte loop", numOps, timer.GetMicroseconds() );
+	size_t expected = total;
+
+	timer.Start();
+	total = 0;
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ ) {
+			og::String::BothLengths( lines[i].c_str(), &byteLen, &len );
+			total += len;
+		}
+	}
+	PrintResult( "lengths: String::BothLengths", numOps, timer.GetMicroseconds() );
+	if ( total != expected )
+		printf( "  error: counted %d characters instead of %d\n", static_cast<int>(total), static_cast<int>(expected) );
+
+	// compare every line with a different case version of itself, like a case insensitive key lookup hit
+	og::List<og::String> upper;
+	for( int i=0; i<numLines; i++ ) {
+		og::String &str = upper.Alloc();
+		str = lines[i];
+		for( char *c=str.raw_ptr(); *c; c++ ) {
+			if ( *c >= 'a' && *c <= 'z' )
+				*c -= 'a' - 'A';
+		}
+	}
+	int numEqual = 0;
+	timer.Start();
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ )
+			numEqual += oldIcmp( lines[i].c_str(), upper[i].c_str() ) == 0;
+	}
+	PrintResult( "icmp: byte loop", numOps, timer.GetMicroseconds() );
+
+	numEqual = 0;
+	timer.Start();
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ )
+			numEqual += og::String::Icmp( lines[i].c_str(), upper[i].c_str() ) == 0;
+	}
+	PrintResult( "icmp: String::Icmp", numOps, timer.GetMicroseconds() );
+	if ( numEqual != numOps )
+		printf( "  error: only %d of %d equal\n", numEqual, numOps );
+
+	int found = 0;
+	timer.Start();
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ )
+			found += oldFind( lines[i].c_str(), "monsters/" ) != -1;
+	}
+	PrintResult( "find: byte loop", numOps, timer.GetMicroseconds() );
+	int expectedFound = found;
+
+	found = 0;
+	timer.Start();
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ )
+			found += lines[i].Find( "monsters/" ) != -1;
+	}
+	PrintResult( "find: String::Find", numOps, timer.GetMicroseconds() );
+	if ( found != expectedFound )
+		printf( "  error: found %d instead of %d\n", found, expectedFound );
+
+	found = 0;
+	timer.Start();
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ )
+			found += oldFindOneOf( lines[i].c_str(), "{}.;" ) != -1;
+	}
+	PrintResult( "findoneof: byte loop", numOps, timer.GetMicroseconds() );
+	expectedFound = found;
+
+	found = 0;
+	timer.Start();
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ )
+			found += lines[i].FindOneOf( "{}.;" ) != -1;
+	}
+	PrintResult( "findoneof: String::FindOneOf", numOps, timer.GetMicroseconds() );
+	if ( found != expectedFound )
+		printf( "  error: found %d instead of %d\n", found, expectedFound );
+
+	// strip the colors off fresh copies each run, copying is part of both timings
+	og::List<og::String> copies;
+	for( int i=0; i<numLines; i++ )
+		copies.Alloc();
+	total = 0;
+	timer.Start();
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ ) {
+			copies[i] = lines[i];
+			total += oldStripEscapeColor( copies[i].raw_ptr() );
+		}
+	}
+	PrintResult( "stripcolors: byte loop", numOps, timer.GetMicroseconds() );
+	expected = total;
+
+	total = 0;
+	timer.Start();
+	for( int r=0; r<STRING_NUM_RUNS; r++ ) {
+		for( int i=0; i<numLines; i++ ) {
+			copies[i] = lines[i];
+			total += og::String::StripEscapeColor( copies[i].raw_ptr() );
+		}
+	}
+	PrintResult( "stripcolors: String::StripEscapeColor", numOps, timer.GetMicroseconds() );
+	if ( total != expected )
+		printf( "  error: removed %d bytes instead of %d\n", static_cast<int>(total), static_cast<int>(expected) );
+}
@@ -0,0 +1,83 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Thread local storage benchmarks
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include "Benchmark.h"
+
+const int TLS_OPS = 10000000;
+
+static og::TLS<int> tlsValue(0);
+static volatile int tlsSink = 0;	// results go here, so the loops can't be dropped
+#ifdef OG_THREAD_LOCAL
+static OG_THREAD_LOCAL int compilerValue = 0;
+#endif
+
+/*
+================
+BenchTLS
+================
+*/
+void BenchTLS( void ) {
+	int sum;
+
+	// The os lookup TLS<T>::Get used on every access before
+	{
+		og::TLS_Index index;
+		int value = 1;
+		index.SetValue( &value );
+		sum = 0;
+		BenchTimer timer;
+		for( int i=0; i<TLS_OPS; i++ )
+			sum += *static_cast<int *>( index.GetValue() );
+		PrintResult( "TLS_Index::GetValue (os)", TLS_OPS, timer.GetMicroseconds() );
+		tlsSink = sum;
+		index.SetValue( NULL );
+	}
+	{
+		*tlsValue = 1;
+		sum = 0;
+		BenchTimer timer;
+		for( int i=0; i<TLS_OPS; i++ )
+			sum += *tlsValue.Get();
+		PrintResult( "TLS<int>::Get", TLS_OPS, timer.GetMicroseconds() );
+		tlsSink = sum;
+	}
+#ifdef OG_THREAD_LOCAL
+	{
+		compilerValue = 1;
+		sum = 0;
+		BenchTimer timer;
+		for( int i=0; i<TLS_OPS; i++ ) {
+			sum += compilerValue;
+			og::CompilerFence();
+		}
+		PrintResult( "OG_THREAD_LOCAL int (baseline)", TLS_OPS, timer.GetMicroseconds() );
+		tlsSink = sum;
+	}
+#endif
+}
@@ -0,0 +1,94 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Micro benchmarks
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <stdio.h>
+#include <og/Common.h>
+#include <og/Common/Thread/Thread.h>
+#include <og/Common/Thread/Atomic.h>
+
+/*
+==============================================================================
+
+  BenchTimer
+
+==============================================================================
+*/
+class BenchTimer {
+public:
+	BenchTimer() { Start(); }
+
+	void		Start( void ) { start = og::SysInfo::GetHiResTime(); }
+	uLongLong	GetMicroseconds( void ) const { return og::SysInfo::GetHiResTime() - start; }
+
+private:
+	uLongLong	start;
+};
+
+/*
+==============================================================================
+
+  BenchThread
+
+  Runs Work() once, then idles until Stop() gets called,
+  so Stop() never deletes a thread that is just finishing.
+
+==============================================================================
+*/
+class BenchThread : public og::Thread {
+public:
+	BenchThread( og::AtomicInt *_numDone ) : numDone(_numDone) {}
+
+protected:
+	virtual void	Work( void ) = 0;
+
+	void Run( void ) {
+		Work();
+		numDone->Increment();
+		while( keepRunning )
+			WaitForWakeUp();
+	}
+
+private:
+	og::AtomicInt *numDone;
+};
+
+// Print one result line
+void PrintResult( const char *name, int numOps, uLongLong usec );
+
+// Benchmarks
+void BenchQueues( void );
+void BenchSharedMutex( void );
+void BenchTLS( void );
+void BenchHashIndex( void );
+void BenchString( void );
+
+#endif
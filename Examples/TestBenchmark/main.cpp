@@ -0,0 +1,74 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Micro benchmarks
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include "Benchmark.h"
+
+struct BenchmarkEntry {
+	const char *	name;
+	void			(*func)( void );
+};
+
+static BenchmarkEntry benchmarks[] = {
+	{ "queues", BenchQueues },
+	{ "sharedmutex", BenchSharedMutex },
+	{ "tls", BenchTLS },
+	{ "hashindex", BenchHashIndex },
+	{ "string", BenchString },
+	{ NULL, NULL }
+};
+
+/*
+================
+PrintResult
+================
+*/
+void PrintResult( const char *name, int numOps, uLongLong usec ) {
+	double nsPerOp = numOps > 0 ? static_cast<double>(usec) * 1000.0 / static_cast<double>(numOps) : 0.0;
+	printf( "  %-40s %10.3f ms %10.2f ns/op\n", name, static_cast<double>(usec) / 1000.0, nsPerOp );
+}
+
+/*
+================
+main
+
+Runs all benchmarks, or only the ones named on the command line
+================
+*/
+int main( int argc, char* argv[] ) {
+	for( int i=0; benchmarks[i].name != NULL; i++ ) {
+		bool run = argc < 2;
+		for( int j=1; j<argc && !run; j++ )
+			run = og::String::Icmp( argv[j], benchmarks[i].name ) == 0;
+		if ( run ) {
+			printf( "%s:\n", benchmarks[i].name );
+			benchmarks[i].func();
+		}
+	}
+	return 0;
+}
@@ -116,6 +116,11 @@ namespace og {
 	// ==============================================================================
 	class AudioEffect {
 	public:
+		// ==============================================================================
+		//! Virtual Destructor
+		// ==============================================================================
+		virtual ~AudioEffect() {}
+
 		// ==============================================================================
 		//! Load a reverb into the effect, overwrites the last effect
 		//!
@@ -191,6 +191,20 @@ namespace og {
 		//! @param	effect		Pointer to the object to be freed
 		// ==============================================================================
 		virtual void				FreeEffect( AudioEffect *effect ) = 0;
+
+		// ==============================================================================
+		//! Start collecting emitter changes made by this thread
+		//!
+		//! Until FlushBatch gets called, the changes are kept in a per thread batch,
+		//! repeated changes to the same emitter property only keep the last value.
+		//! Calls can be nested.
+		// ==============================================================================
+		virtual void				BeginBatch( void ) = 0;
+
+		// ==============================================================================
+		//! Send the changes collected since BeginBatch to the audio thread at once
+		// ==============================================================================
+		virtual void				FlushBatch( void ) = 0;
 	};
 
 	// ==============================================================================
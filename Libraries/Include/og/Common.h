@@ -38,10 +38,12 @@
 
 // Public Library Includes
 #include <og/Common/Thread/ThreadLocalStorage.h>
+#include <og/Common/Containers/Sort.h>
 #include <og/Common/Containers/List.h>
 #include <og/Common/Containers/LinkedList.h>
 #include <og/Common/Containers/Stack.h>
 #include <og/Common/Containers/HashIndex.h>
+#include <og/Common/Containers/SlotMap.h>
 #include <og/Common/Containers/StringPool.h>
 #include <og/Common/Containers/Dict.h>
 #include <og/Common/Containers/Pair.h>
@@ -54,10 +56,12 @@
 #include <og/Common/Common.h>
 
 // We include .inl files last, so we can access all classes here.
+#include <og/Common/Containers/Sort.inl>
 #include <og/Common/Containers/List.inl>
 #include <og/Common/Containers/LinkedList.inl>
 #include <og/Common/Containers/Stack.inl>
 #include <og/Common/Containers/HashIndex.inl>
+#include <og/Common/Containers/SlotMap.inl>
 #include <og/Common/Containers/Dict.inl>
 #include <og/Common/Containers/Pair.inl>
 #include <og/Common/Containers/DynBuffer.inl>
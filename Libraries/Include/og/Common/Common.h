@@ -60,6 +60,8 @@ namespace og {
 	// ==============================================================================
 	//! QuickSort
 	//!
+	//! @note	For typed arrays, IntroSort and MergeSort are faster, since the comparison can be inlined
+	//!
 	//! @param	base	The start of the target array
 	//! @param	num		The array size in elements
 	//! @param	width	The element size in bytes
@@ -1,6 +1,6 @@
 // ==============================================================================
 //! @file
-//! @brief	Allocator
+//! @brief	Allocators for pooled, per frame and thread local memory
 //! @author	Santo Pfingsten (TTK-Bandit)
 //! @note	Copyright (C) 2007-2010 Lusito Software
 // ==============================================================================
@@ -27,6 +27,7 @@
 //
 // ==============================================================================
 
+
 #ifndef __OG_ALLOCATOR_H__
 #define __OG_ALLOCATOR_H__
 
@@ -38,7 +39,8 @@ namespace og {
 	// ==============================================================================
 	//! Allocator
 	//! 
-	//! Allocates a list of objects instead of manually allocating each object
+	//! Allocates a list of objects instead of manually allocating each object.
+	//! Freed objects get reused by the next Alloc.
 	// ==============================================================================
 	template<class T>
 	class Allocator {
@@ -60,10 +62,29 @@ namespace og {
 		//!
 		//! @return	Pointer to the object
 		//!
-		//! Gets the first free object in the allocation chunk,
-		//! and creates a new chunk if no free objects are left
+		//! Reuses a freed object if possible, otherwise gets the first free object
+		//! in the allocation chunk, and creates a new chunk if no free objects are left
+		// ==============================================================================
+		T *		Alloc( void );
+
+		// ==============================================================================
+		//! Destroy an object and keep its memory for reuse
+		//!
+		//! @param	object	The object, must come from this allocator
+		// ==============================================================================
+		void	Free( T *object );
+
+		// ==============================================================================
+		//! Destroy all objects and free all chunks
 		// ==============================================================================
-		T *Alloc( void );
+		void	Clear( void );
+
+		// ==============================================================================
+		//! Get the number of objects in use
+		//!
+		//! @return	Allocated minus freed objects
+		// ==============================================================================
+		int		Num( void ) const { return numUsed; }
 
 	private:
 
@@ -73,14 +94,107 @@ namespace og {
 		void CreateChunk( void );
 
 		// ==============================================================================
-		//! Holds an array of T with the size of granularity
+		//! Get the memory size of one object, freed objects store the free list link
+		// ==============================================================================
+		static size_t ItemStride( void );
+
+		// ==============================================================================
+		//! Holds memory for granularity objects
 		// ==============================================================================
 		struct allocChunk_t {
-			T *	list;
-			int	last;
+			byte *	list;
+			int		last;
 		};
 		List<allocChunk_t>allocationList;	//!< List of all chunks
 		int granularity;					//!< The granularity
+		int numUsed;						//!< Objects in use
+		void *freeObjects;					//!< Freed objects, linked through their first bytes
+	};
+
+	// ==============================================================================
+	//! Linear allocator for scratch memory
+	//!
+	//! Allocations just move a pointer forward in big blocks, Reset makes all of
+	//! the memory available again at once. Use it for temporaries that only live
+	//! for a frame, by passing it to String, List or DynBuffer.
+	//!
+	//! @note	Free only gives the memory back if it was the latest allocation,
+	//!			everything else waits for Reset
+	//! @note	Not thread safe, see GetThreadAllocator
+	// ==============================================================================
+	class FrameAllocator : public MemoryAllocator {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	blockSize	The size of the memory blocks to allocate in bytes
+		// ==============================================================================
+		FrameAllocator( size_t blockSize=65536 );
+
+		// ==============================================================================
+		//! Destructor
+		// ==============================================================================
+		~FrameAllocator();
+
+		// ==============================================================================
+		//! Allocate memory
+		//!
+		//! @param	size	The size in bytes
+		//!
+		//! @return	Pointer to the memory, aligned to 16 bytes
+		// ==============================================================================
+		void *	Alloc( size_t size );
+
+		// ==============================================================================
+		//! Give memory back, only works for the latest allocation
+		//!
+		//! @param	ptr		Pointer returned by Alloc, may be NULL
+		//! @param	size	The size passed to Alloc
+		// ==============================================================================
+		void	Free( void *ptr, size_t size );
+
+		// ==============================================================================
+		//! Make all memory available again, the blocks are kept for reuse
+		//!
+		//! @warning	Everything allocated before is invalid afterwards
+		// ==============================================================================
+		void	Reset( void );
+
+		// ==============================================================================
+		//! Get the number of bytes allocated since the last Reset
+		//!
+		//! @return	The size in bytes
+		// ==============================================================================
+		size_t	GetUsed( void ) const { return used; }
+
+		// ==============================================================================
+		//! Get the FrameAllocator of the calling thread
+		//!
+		//! @return	The allocator, which lives as long as the thread
+		//!
+		//! @warning	Only use together with og::Thread
+		// ==============================================================================
+		static FrameAllocator *GetThreadAllocator( void );
+
+	private:
+		// ==============================================================================
+		//! A block of memory, the memory follows the header
+		// ==============================================================================
+		struct Block {
+			Block *	next;		//!< The next block
+			size_t	size;		//!< Usable bytes in this block
+		};
+		static const size_t ALIGNMENT = 16;	//!< Alignment of all allocations and the block header size
+
+		Block *		first;		//!< The first block
+		Block *		current;	//!< The block allocations come from, NULL after Reset
+		size_t		offset;		//!< Bytes used in the current block
+		size_t		used;		//!< Bytes allocated since the last Reset
+		size_t		blockSize;	//!< The default block size
+
+		// not copyable
+		FrameAllocator( const FrameAllocator & );
+		FrameAllocator &operator=( const FrameAllocator & );
 	};
 //! @}
 }
@@ -47,7 +47,8 @@ Allocator::Allocator
 */
 template<class T>
 OG_INLINE Allocator<T>::Allocator( int _granularity ) : granularity(_granularity) {
-	CreateChunk();
+	numUsed = 0;
+	freeObjects = NULL;
 }
 
 /*
@@ -57,22 +58,29 @@ Allocator::~Allocator
 */
 template<class T>
 OG_INLINE Allocator<T>::~Allocator() {
-	int num = allocationList.Num();
-	for( int i=0; i<num; i++ )
-		delete[] allocationList[i].list;
-	allocationList.Clear();
+	Clear();
 }
 
 /*
 ================
-Allocator::Free
+Allocator::ItemStride
+================
+*/
+template<class T>
+OG_INLINE size_t Allocator<T>::ItemStride( void ) {
+	return sizeof(T) < sizeof(void *) ? sizeof(void *) : sizeof(T);
+}
+
+/*
+================
+Allocator::CreateChunk
 ================
 */
 template<class T>
 OG_INLINE void Allocator<T>::CreateChunk( void ) {
 	allocChunk_t &chunk = allocationList.Alloc();
 	chunk.last = 0;
-	chunk.list = new T[granularity];
+	chunk.list = static_cast<byte *>( ::operator new( granularity * ItemStride() ) );
 }
 
 /*
@@ -80,15 +88,79 @@ OG_INLINE void Allocator<T>::CreateChunk( void ) {
 Allocator::Alloc
 ================
 */
-
 template<class T>
 OG_INLINE T *Allocator<T>::Alloc( void ) {
-	allocChunk_t &chunk = allocationList[allocationList.Num()-1];
-	T *ret = &chunk.list[chunk.last];
-	chunk.last++;
-	if ( chunk.last >= granularity )
-		CreateChunk();
-	return ret;
+	void *ret;
+	if ( freeObjects ) {
+		ret = freeObjects;
+		freeObjects = *reinterpret_cast<void **>( ret );
+	} else {
+		if ( allocationList.IsEmpty() || allocationList[allocationList.Num()-1].last >= granularity )
+			CreateChunk();
+		allocChunk_t &chunk = allocationList[allocationList.Num()-1];
+		ret = chunk.list + chunk.last * ItemStride();
+		chunk.last++;
+	}
+	numUsed++;
+	return new(ret) T;
+}
+
+/*
+================
+Allocator::Free
+================
+*/
+template<class T>
+OG_INLINE void Allocator<T>::Free( T *object ) {
+	if ( object == NULL )
+		return;
+	object->~T();
+	*reinterpret_cast<void **>( object ) = freeObjects;
+	freeObjects = object;
+	numUsed--;
+}
+
+/*
+================
+Allocator::Clear
+
+Freed objects are already destroyed,
+so they get marked before destroying the rest.
+================
+*/
+template<class T>
+void Allocator<T>::Clear( void ) {
+	int numChunks = allocationList.Num();
+	if ( numChunks == 0 )
+		return;
+
+	size_t chunkSize = granularity * ItemStride();
+	List<bool> isFree;
+	isFree.EnsureAllocated( numChunks * granularity );
+	for( int i=0; i<isFree.Num(); i++ )
+		isFree[i] = false;
+
+	for( void *object = freeObjects; object; object = *reinterpret_cast<void **>( object ) ) {
+		for( int i=0; i<numChunks; i++ ) {
+			byte *list = allocationList[i].list;
+			if ( object >= list && object < list + chunkSize ) {
+				isFree[i * granularity + static_cast<int>( (static_cast<byte *>(object) - list) / ItemStride() )] = true;
+				break;
+			}
+		}
+	}
+
+	for( int i=0; i<numChunks; i++ ) {
+		allocChunk_t &chunk = allocationList[i];
+		for( int j=0; j<chunk.last; j++ ) {
+			if ( !isFree[i * granularity + j] )
+				reinterpret_cast<T *>( chunk.list + j * ItemStride() )->~T();
+		}
+		::operator delete( chunk.list );
+	}
+	allocationList.Clear();
+	numUsed = 0;
+	freeObjects = NULL;
 }
 
 }
@@ -137,8 +137,10 @@ namespace og {
 		//! @param	value	The value
 		// ==============================================================================
 		void		Set( const char *key, const char *value );
+		void		Set( const char *key, const StringView &value );
 		void		Set( const char *key, const Format &value );
 		void		Set( const char *key, const String &value );
+		void		Set( const Name &key, const StringView &value );
 
 		template<class T> void Set( const char *key, const T &value );
 
@@ -151,6 +153,7 @@ namespace og {
 		//! @return	A temporary object to use for conversion to other types
 		// ==============================================================================
 		StringType	Get( const char *key, const char *defaultValue ) const;
+		StringType	Get( const Name &key, const char *defaultValue ) const;
 
 		// ==============================================================================
 		//! Get the value for the specified key and find out if the key existed
@@ -162,6 +165,7 @@ namespace og {
 		//! @return	true if the key existed
 		// ==============================================================================
 		template<class T> bool Get( const char *key, const char *defaultValue, T &value ) const;
+		template<class T> bool Get( const Name &key, const char *defaultValue, T &value ) const;
 
 		// ==============================================================================
 		//! Find the index of the specified key
@@ -172,6 +176,15 @@ namespace og {
 		// ==============================================================================
 		int			Find( const char *key ) const;
 
+		// ==============================================================================
+		//! Find the index of the specified key, without hashing it again
+		//!
+		//! @param	key	The key
+		//!
+		//! @return	Zero-based index of the key, -1 if not found.
+		// ==============================================================================
+		int			Find( const Name &key ) const;
+
 		// ==============================================================================
 		//! Find all entries that start with a prefix
 		//!
@@ -215,6 +228,7 @@ namespace og {
 		//! @return	A temporary object to use for conversion to other types
 		// ==============================================================================
 		StringType	operator[]( const char *key ) const;
+		StringType	operator[]( const Name &key ) const;
 
 		// ==============================================================================
 		//! Get a value by its index
@@ -226,8 +240,7 @@ namespace og {
 		StringType	operator[]( int index ) const;
 
 	private:
-		static TLS<StringPool>	keyPool;	//!< The key pool ( thread local )
-		static TLS<StringPool>	valuePool;	//!< The value pool ( thread local )
+		static SharedStringPool	valuePool;	//!< The value pool ( shared by all threads ), keys are stored in the Name pool
 
 		ListEx<KeyValue>	entries;		//!< The entries list
 		HashIndex			hashIndex;		//!< Hash index for faster key access
@@ -310,6 +323,15 @@ namespace og {
 		//! @return	Zero-based index of the key, -1 if not found.
 		// ==============================================================================
 		int			Find( const char *key ) const;
+
+		// ==============================================================================
+		//! Find the index of the specified key, without hashing it again
+		//!
+		//! @param	key	The key
+		//!
+		//! @return	Zero-based index of the key, -1 if not found.
+		// ==============================================================================
+		int			Find( const Name &key ) const;
 		
 		// ==============================================================================
 		//! Find the first index of the entry where the value matches the specified one
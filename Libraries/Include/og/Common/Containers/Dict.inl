@@ -46,7 +46,6 @@ Dict::Dict
 ================
 */
 OG_INLINE Dict::Dict() {
-	SetGranularity(16);
 }
 
 /*
@@ -82,8 +81,11 @@ OG_INLINE const KeyValue *Dict::GetKeyValue( int index ) const {
 Dict::Set
 ================
 */
+OG_INLINE void Dict::Set( const char *key, const char *value ) {
+	Set( key, StringView( value ) );
+}
 OG_INLINE void Dict::Set( const char *key, const String &value ) {
-	Set( key, value.c_str() );
+	Set( key, StringView( value ) );
 }
 OG_INLINE void Dict::Set( const char *key, const Format &value ) {
 	Set( key, value.c_str() );
@@ -102,6 +104,16 @@ bool Dict::Get( const char *key, const char *defaultValue, T &out ) const {
 	out = entries[index].GetValue();
 	return true;
 }
+template<class T>
+bool Dict::Get( const Name &key, const char *defaultValue, T &out ) const {
+	int index = Find( key );
+	if ( index == -1 ) {
+		out = StringType( defaultValue );
+		return false;
+	}
+	out = entries[index].GetValue();
+	return true;
+}
 
 /*
 ================
@@ -111,6 +123,9 @@ Dict::operator[]
 OG_INLINE StringType Dict::operator[]( const char *key ) const {
 	return Get(key, "");
 }
+OG_INLINE StringType Dict::operator[]( const Name &key ) const {
+	return Get(key, "");
+}
 OG_INLINE StringType Dict::operator[]( int index ) const {
 	OG_ASSERT( index >= 0 && index <= entries.Num() );
 	return entries[index].GetValue();
@@ -142,7 +157,6 @@ DictEx::DictEx
 */
 template<class T>
 OG_INLINE DictEx<T>::DictEx() {
-	SetGranularity(16);
 }
 
 /*
@@ -280,6 +294,18 @@ int DictEx<T>::Find( const char *key ) const {
 
 	return -1;
 }
+template<class T>
+int DictEx<T>::Find( const Name &key ) const {
+	if ( key.IsEmpty() )
+		return -1;
+
+	for ( int i = hashIndex.First( key.GetHash() ); i != -1; i = hashIndex.Next() ) {
+		if ( names[i].Icmp( key.c_str() ) == 0 )
+			return i;
+	}
+
+	return -1;
+}
 
 /*
 ================
@@ -44,9 +44,10 @@ namespace og {
 		// ==============================================================================
 		//! Constructor
 		//!
-		//! @param	size	The initial size
+		//! @param	size		The initial size
+		//! @param	allocator	Where the buffer gets allocated, NULL for the heap
 		// ==============================================================================
-		DynBuffer( int size=0 );
+		DynBuffer( int size=0, MemoryAllocator *allocator=NULL );
 
 		// ==============================================================================
 		//! Destructor
@@ -67,6 +68,18 @@ namespace og {
 
 		T *		data;	//!< The buffer
 		int		size;	//!< The buffer size
+
+	private:
+		MemoryAllocator *allocator;	//!< Where the buffer gets allocated, NULL for the heap
+
+		// not copyable
+		DynBuffer( const DynBuffer<T> & );
+		DynBuffer<T> &operator=( const DynBuffer<T> & );
+
+		// ==============================================================================
+		//! Allocate and construct size items
+		// ==============================================================================
+		void	Allocate( void );
 	};
 //! @}
 }
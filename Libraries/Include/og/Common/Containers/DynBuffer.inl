@@ -46,10 +46,11 @@ DynBuffer::DynBuffer
 ================
 */
 template<class T>
-OG_INLINE DynBuffer<T>::DynBuffer( int _size ) {
+OG_INLINE DynBuffer<T>::DynBuffer( int _size, MemoryAllocator *_allocator ) {
+	allocator = _allocator;
 	size = _size;
 	if ( size > 0 )
-		data = new T[size];
+		Allocate();
 	else
 		data = NULL;
 }
@@ -71,7 +72,12 @@ DynBuffer::Clear
 */
 template<class T>
 OG_INLINE void DynBuffer<T>::Clear( void ) {
-	SafeDeleteArray( data );
+	if ( data ) {
+		for( int i=0; i<size; i++ )
+			data[i].~T();
+		MemFree( allocator, data, size * sizeof(T) );
+		data = NULL;
+	}
 	size = 0;
 }
 
@@ -83,13 +89,25 @@ DynBuffer::CheckSize
 template<class T>
 OG_INLINE void DynBuffer<T>::CheckSize( int newSize ) {
 	if ( newSize > size ) {
-		delete[] data;
+		Clear();
 
 		size = newSize;
-		data = new T[size];
+		Allocate();
 	}
 }
 
+/*
+================
+DynBuffer::Allocate
+================
+*/
+template<class T>
+OG_INLINE void DynBuffer<T>::Allocate( void ) {
+	data = static_cast<T *>( MemAlloc( allocator, size * sizeof(T) ) );
+	for( int i=0; i<size; i++ )
+		new(&data[i]) T;
+}
+
 }
 
 #endif
@@ -37,13 +37,16 @@ namespace og {
 
 	// ==============================================================================
 	//! Hash index
+	//!
+	//! Maps hash values to indices of another container. Open addressing with robin hood
+	//! probing: hash/index pairs are stored inline and the table grows when it gets 3/4 full.
 	// ==============================================================================
 	class HashIndex {
 	public:
 		// ==============================================================================
 		//! Constructor
 		//!
-		//! @param	hashSize	Size of the hash
+		//! @param	hashSize	Initial number of slots, must be a power of two
 		// ==============================================================================
 		HashIndex( int hashSize=128 );
 
@@ -55,7 +58,7 @@ namespace og {
 		// ==============================================================================
 		//! Free all memory and reset to new size
 		//!
-		//! @param	newHashSize	Size of the new hash
+		//! @param	newHashSize	Initial number of slots after the reset, -1 to keep the current one
 		// ==============================================================================
 		void	Clear( int newHashSize=-1 );
 
@@ -70,10 +73,24 @@ namespace og {
 		// ==============================================================================
 		//! Remove this entry
 		//!
-		//! @param	hash	The hash entry
-		//! @param	index	Zero-based index
+		//! With shiftIndices, all indices above index get decreased by one, like List::Remove
+		//! does with its elements. That has to touch every entry, so containers that don't shift
+		//! their elements should pass false, which makes this O(1).
+		//!
+		//! @param	hash			The hash entry
+		//! @param	index			Zero-based index
+		//! @param	shiftIndices	Decrease the indices above index
 		// ==============================================================================
-		void	Remove( int hash, int index );
+		void	Remove( int hash, int index, bool shiftIndices=true );
+
+		// ==============================================================================
+		//! Change the index of an entry, for example after moving the last element into a gap
+		//!
+		//! @param	hash		The hash entry
+		//! @param	oldIndex	The current index
+		//! @param	newIndex	The new index
+		// ==============================================================================
+		void	Reindex( int hash, int oldIndex, int newIndex );
 
 		// ==============================================================================
 		//! Get the first entry with the specified hash value
@@ -92,6 +109,13 @@ namespace og {
 		// ==============================================================================
 		int		Next( void ) const;
 
+		// ==============================================================================
+		//! Get the number of entries
+		//!
+		//! @return	The number of entries
+		// ==============================================================================
+		int		Num( void ) const { return numEntries; }
+
 		// ==============================================================================
 		//! Generate a hash key
 		//!
@@ -101,6 +125,7 @@ namespace og {
 		//! @return	The key. 
 		// ==============================================================================
 		static int GenerateKey( const char *value, bool caseSensitive );
+		static int GenerateKey( const StringView &value, bool caseSensitive );
 
 	private:
 
@@ -109,20 +134,56 @@ namespace og {
 		// ==============================================================================
 		void	Init( void );
 
-		int		hashSize;		//!< Size of the hash list, bigger hashsize = less collisions, but more memory
+		// ==============================================================================
+		//! Double the number of slots and insert all entries again
+		// ==============================================================================
+		void	Grow( void );
+
+		// ==============================================================================
+		//! Insert an entry, without checking for duplicates or the load factor
+		//!
+		//! @param	hash	The hash entry
+		//! @param	index	Zero-based index
+		// ==============================================================================
+		void	Insert( int hash, int index );
+
+		// ==============================================================================
+		//! Find the slot of an entry
+		//!
+		//! @param	hash	The hash entry
+		//! @param	index	Zero-based index
+		//!
+		//! @return	-1 if not found, otherwise the slot
+		// ==============================================================================
+		int		FindSlot( int hash, int index ) const;
+
+		// ==============================================================================
+		//! Get how far a slot is from the home slot of a hash
+		// ==============================================================================
+		int		ProbeDistance( int slot, int hash ) const { return (slot - hash) & mask; }
+
+		// ==============================================================================
+		//! Continue the search of First/Next at findSlot
+		// ==============================================================================
+		int		Scan( void ) const;
+
+		int		hashSize;		//!< Number of slots, always a power of two
 		int		mask;			//!< The hash mask
-		bool	initialized;	//!< true when the hash list is initialized
+		bool	initialized;	//!< true when the slots are allocated
+		int		numEntries;		//!< Number of used slots
 
 		// ==============================================================================
-		//! Hash index node
+		//! Hash index slot
 		// ==============================================================================
-		struct HashIndexNode_s {
-			HashIndexNode_s *next;
-			int				index;
+		struct HashIndexSlot_s {
+			int		hash;	//!< The hash value
+			int		index;	//!< The index, -1 if the slot is empty
 		};
-		HashIndexNode_s **nodeList;			//!< List of nodelists
-		List<HashIndexNode_s *> allnodes;	//!< List of all nodes
-		mutable HashIndexNode_s *findNode;	//!< The find node
+		HashIndexSlot_s *slots;		//!< The slots
+
+		mutable int	findHash;		//!< The hash being searched by First/Next
+		mutable int	findSlot;		//!< The slot to look at next, -1 when done
+		mutable int	findDistance;	//!< The probe distance of findSlot
 	};
 //! @}
 }
@@ -46,12 +46,12 @@ HashIndex::First
 ================
 */
 OG_INLINE int HashIndex::First( int hash ) const {
-	if ( initialized ) {
-		findNode = nodeList[(hash & mask)];
-		if ( findNode )
-			return findNode->index;
-	}
-	return -1;
+	if ( !initialized )
+		return -1;
+	findHash = hash;
+	findSlot = hash & mask;
+	findDistance = 0;
+	return Scan();
 }
 
 /*
@@ -60,12 +60,31 @@ HashIndex::Next
 ================
 */
 OG_INLINE int HashIndex::Next( void ) const {
-	if ( initialized && findNode ) {
-		findNode = findNode->next;
-		if ( findNode )
-			return findNode->index;
+	if ( !initialized || findSlot == -1 )
+		return -1;
+	findSlot = (findSlot + 1) & mask;
+	findDistance++;
+	return Scan();
+}
+
+/*
+================
+HashIndex::Scan
+================
+*/
+OG_INLINE int HashIndex::Scan( void ) const {
+	for(;;) {
+		const HashIndexSlot_s &slot = slots[findSlot];
+		// robin hood: once the entries are closer to their home than we are, ours can't follow
+		if ( slot.index == -1 || ProbeDistance( findSlot, slot.hash ) < findDistance ) {
+			findSlot = -1;
+			return -1;
+		}
+		if ( slot.hash == findHash )
+			return slot.index;
+		findSlot = (findSlot + 1) & mask;
+		findDistance++;
 	}
-	return -1;
 }
 
 /*
@@ -76,6 +95,9 @@ HashIndex::GenerateKey
 OG_INLINE int HashIndex::GenerateKey( const char *value, bool caseSensitive ) {
 	return FNV32(value, caseSensitive);
 }
+OG_INLINE int HashIndex::GenerateKey( const StringView &value, bool caseSensitive ) {
+	return FNV32(value.GetData(), value.ByteLength(), caseSensitive);
+}
 
 }
 
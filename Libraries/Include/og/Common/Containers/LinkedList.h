@@ -207,6 +207,15 @@ namespace og {
 		// ==============================================================================
 		void		SortEx( cmpFuncEx_t compare, void *param, bool removeDupes );
 
+		// ==============================================================================
+		//! Sort the list with a less functor and (optional) remove duplicates
+		//!
+		//! @param	less		Function or functor: bool less( const T &a, const T &b )
+		//! @param	removeDupes	true to remove duplicates
+		// ==============================================================================
+		template<class Less>
+		void		SortWith( Less less, bool removeDupes=false );
+
 	// operators
 		// ==============================================================================
 		//! Copy all entries from the other list
@@ -237,46 +246,16 @@ namespace og {
 		nodeType *	end;	//!< Pointer to the list end
 
 		// ==============================================================================
-		//! Comparison callback
-		//!
-		//! @param	context	A pointer to the CompareData object
-		//! @param	a		A pointer to the first object
-		//! @param	b		A pointer to the second object
-		//!
-		//! @return	0 if the objects match, otherwise positive or negative
-		// ==============================================================================
-		static int	CompareCallback( void *context, const void *a, const void *b );
-
-		// ==============================================================================
-		//! Comparison callback
-		//!
-		//! @param	context	A pointer to the CompareDataEx object
-		//! @param	a	A pointer to the first object
-		//! @param	b	A pointer to the second object
-		//!
-		//! @return	0 if the objects match, otherwise positive or negative
-		// ==============================================================================
-		static int	CompareCallbackEx( void *context, const void *a, const void *b );
-		
-		// ==============================================================================
-		//! Comparison data
-		// ==============================================================================
-		class CompareData {
-		public:
-			CompareData( cmpFunc_t f ) : func(f) {}
-
-			cmpFunc_t	func;		//!< The normal comparison function
-		};
-
-		// ==============================================================================
-		//! Comparison data with parameter
+		//! Compares the values of two nodes with another less functor
 		// ==============================================================================
-		class CompareDataEx {
+		template<class Less>
+		class NodeLess {
 		public:
-			CompareDataEx( cmpFuncEx_t f, void *p ) : func(f), param(p) {}
+			NodeLess( Less l ) : less(l) {}
+			bool operator()( const nodeType *a, const nodeType *b ) const { return less( a->value, b->value ); }
 
-			cmpFuncEx_t	func;		//!< The extended comparison function
-			void		*param;		//!< The parameter ( for the extended comparison )
+		private:
+			Less	less;		//!< The functor for the values
 		};
 	};
 //! @}
@@ -304,37 +304,7 @@ Sorts the list and removes duplicates.
 */
 template<class T>
 void LinkedList<T>::Sort( cmpFunc_t compare, bool removeDupes ) {
-	if ( num < 2 )
-		return;
-	
-	nodeType **list = new nodeType*[num];
-	int i = 0;
-	for( nodeType *node=start; node; node=node->next, i++ )
-		list[i] = node;
-
-	CompareData cmpData( this, compare );
-	QuickSort( list, num, sizeof( nodeType * ), &cmpData, CompareCallback );
-
-	for( i=1; i<num; i++ ) {
-		list[i]->prev = list[i-1];
-		list[i-1]->next = list[i];
-	}
-
-	start = list[0];
-	end = list[num-1];
-
-	start->prev = NULL;
-	end->next = NULL;
-
-	delete[] list;
-	list = NULL;
-
-	if ( removeDupes ) {
-		for( nodeType *node=start; node->next; node=node->next ) {
-			if ( compare( node->value, node->next->value ) == 0 )
-				Remove( node->next );
-		}
-	}
+	SortWith( CompareLess<T>( compare ), removeDupes );
 }
 
 /*
@@ -346,16 +316,29 @@ Sorts the list and removes duplicates.
 */
 template<class T>
 void LinkedList<T>::SortEx( cmpFuncEx_t compare, void *param, bool removeDupes ) {
+	SortWith( CompareLessEx<T>( compare, param ), removeDupes );
+}
+
+/*
+================
+LinkedList::SortWith
+
+Sorts an array of the nodes
+and links them again in the new order.
+================
+*/
+template<class T>
+template<class Less>
+void LinkedList<T>::SortWith( Less less, bool removeDupes ) {
 	if ( num < 2 )
 		return;
-	
+
 	nodeType **list = new nodeType*[num];
 	int i = 0;
 	for( nodeType *node=start; node; node=node->next, i++ )
 		list[i] = node;
 
-	CompareDataEx cmpData( this, compare, param );
-	QuickSort( list, num, sizeof( nodeType * ), &cmpData, CompareCallbackEx );
+	IntroSort( list, num, NodeLess<Less>( less ) );
 
 	for( i=1; i<num; i++ ) {
 		list[i]->prev = list[i-1];
@@ -369,42 +352,18 @@ void LinkedList<T>::SortEx( cmpFuncEx_t compare, void *param, bool removeDupes )
 	end->next = NULL;
 
 	delete[] list;
-	list = NULL;
 
 	if ( removeDupes ) {
-		for( nodeType *node=start; node->next; node=node->next ) {
-			if ( compare( node->value, node->next->value ) == 0 )
+		nodeType *node = start;
+		while( node->next ) {
+			if ( less( node->value, node->next->value ) )
+				node = node->next;
+			else
 				Remove( node->next );
 		}
 	}
 }
 
-/*
-================
-LinkedList::CompareCallback
-================
-*/
-template<class T>
-int LinkedList<T>::CompareCallback( void *context, const void *a, const void *b ) {
-	const nodeType *pa = *(const nodeType **)a;
-	const nodeType *pb = *(const nodeType **)b;
-	CompareData *cmpData = reinterpret_cast<CompareData *>(context);
-	return cmpData->func( pa->value, pb->value );
-}
-
-/*
-================
-LinkedList::CompareCallbackEx
-================
-*/
-template<class T>
-int LinkedList<T>::CompareCallbackEx( void *context, const void *a, const void *b ) {
-	const nodeType *pa = *(const nodeType **)a;
-	const nodeType *pb = *(const nodeType **)b;
-	CompareDataEx *cmpData = reinterpret_cast<CompareDataEx *>(context);
-	return cmpData->func( pa->value, pb->value, cmpData->param );
-}
-
 }
 
 #endif
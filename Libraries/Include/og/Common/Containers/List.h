@@ -30,17 +30,56 @@
 #ifndef __OG_LIST_H__
 #define __OG_LIST_H__
 
+#include <new>
+#include <string.h>
 
 //! Open Game Libraries
 namespace og {
 //! @defgroup Common Common (Library)
 //! @{
 
+	// ==============================================================================
+	//! Tells the containers if objects of a type can be moved in memory with memcpy
+	//!
+	//! True for builtin types and pointers. Use OG_RELOCATABLE_TYPE to mark
+	//! your own plain structs ( outside of any namespace ).
+	// ==============================================================================
+	template<class T> struct IsRelocatable { enum { value = false }; };
+	template<class T> struct IsRelocatable<T *> { enum { value = true }; };
+	template<> struct IsRelocatable<bool> { enum { value = true }; };
+	template<> struct IsRelocatable<char> { enum { value = true }; };
+	template<> struct IsRelocatable<signed char> { enum { value = true }; };
+	template<> struct IsRelocatable<unsigned char> { enum { value = true }; };
+	template<> struct IsRelocatable<short> { enum { value = true }; };
+	template<> struct IsRelocatable<unsigned short> { enum { value = true }; };
+	template<> struct IsRelocatable<int> { enum { value = true }; };
+	template<> struct IsRelocatable<unsigned int> { enum { value = true }; };
+	template<> struct IsRelocatable<long> { enum { value = true }; };
+	template<> struct IsRelocatable<unsigned long> { enum { value = true }; };
+	template<> struct IsRelocatable<float> { enum { value = true }; };
+	template<> struct IsRelocatable<double> { enum { value = true }; };
+
+#define OG_RELOCATABLE_TYPE( type ) \
+	namespace og { template<> struct IsRelocatable< type > { enum { value = true }; }; }
+
+	// ==============================================================================
+	//! Move objects into uninitialized memory, the source objects get destroyed
+	//!
+	//! Relocatable types get copied with memcpy, others get copy constructed.
+	//! Specialize it for types that can take over the resources of the source object.
+	//!
+	//! @param	dest	Uninitialized memory for count objects
+	//! @param	src		The objects to move
+	//! @param	count	The number of objects
+	// ==============================================================================
+	template<class T>
+	void		RelocateItems( T *dest, T *src, int count );
+
 	// ==============================================================================
 	//! List -> use for small items
 	//!
-	//! @note	Everytime the list gets resized, it will create a new array of items
-	//!			and delete the old one. This is very inefficient for bigger items.
+	//! @note	Items are constructed only when they get used. When the list needs to
+	//!			grow, the items get relocated to a new array ( see RelocateItems ).
 	//!	@warning	If you decide to use List with a class/struct, which contains
 	//!				dynamic memory, make sure the class has a copy constructor.
 	// ==============================================================================
@@ -50,13 +89,16 @@ namespace og {
 		// ==============================================================================
 		//! Constructor
 		//!
-		//! @param	granularity	The granularity
+		//! @param	granularity	The granularity, 0 to grow by half of the current size
+		//! @param	allocator	Where the items get allocated, NULL for the heap
 		// ==============================================================================
-		List( int granularity = 16 );
+		List( int granularity = 0, MemoryAllocator *allocator = NULL );
 
 		// ==============================================================================
 		//! Copy Constructor
 		//!
+		//! The copy uses the heap, not the allocator of the other list.
+		//!
 		//! @param	other	The list to copy from
 		// ==============================================================================
 		List( const List<T> &other );
@@ -105,7 +147,7 @@ namespace og {
 		// ==============================================================================
 		//! Set the granularity
 		//!
-		//! @param	granularity	The new granularity
+		//! @param	granularity	The new granularity, 0 to grow by half of the current size
 		// ==============================================================================
 		void		SetGranularity( int granularity );
 
@@ -116,6 +158,13 @@ namespace og {
 		// ==============================================================================
 		int			GetGranularity( void ) const;
 
+		// ==============================================================================
+		//! Set where the items get allocated, this clears the list
+		//!
+		//! @param	allocator	The allocator, NULL for the heap
+		// ==============================================================================
+		void		SetAllocator( MemoryAllocator *allocator );
+
 		// ==============================================================================
 		//! Get the next unused item, resize the list if needed
 		//!
@@ -178,6 +227,23 @@ namespace og {
 		// ==============================================================================
 		void		SortEx( cmpFuncEx_t compare, void *param, bool removeDupes );
 
+		// ==============================================================================
+		//! Sort the list with a less functor and (optional) remove duplicates
+		//!
+		//! @param	less		Function or functor: bool less( const T &a, const T &b )
+		//! @param	removeDupes	true to remove duplicates
+		// ==============================================================================
+		template<class Less>
+		void		SortWith( Less less, bool removeDupes=false );
+
+		// ==============================================================================
+		//! Sort the list with a less functor and keep the order of equal items
+		//!
+		//! @param	less		Function or functor: bool less( const T &a, const T &b )
+		// ==============================================================================
+		template<class Less>
+		void		StableSortWith( Less less );
+
 		// ==============================================================================
 		//! Check if it needs resizing, and do it
 		//!
@@ -218,55 +284,24 @@ namespace og {
 		int			num;			//<! Number of used items
 		int			size;			//<! Total number of items
 		T *			list;			//<! Pointer to the list
+		MemoryAllocator *allocator;	//<! Where the items get allocated, NULL for the heap
 
 		// ==============================================================================
-		//! Resize to the size and (optional) keep the content
+		//! Get the number of items to allocate when the list needs to grow
 		//!
-		//! @param	newSize		The new list size
-		//! @param	keepContent	true to keep the content
-		// ==============================================================================
-		void		Resize( int newSize, bool keepContent );
-
-		// ==============================================================================
-		//! Comparison callback
+		//! @param	newSize		The number of items needed
 		//!
-		//! @param	a	A pointer to the first object
-		//! @param	b	A pointer to the second object
-		//!
-		//! @return	0 if the objects match, otherwise positive or negative
+		//! @return	The new allocation size
 		// ==============================================================================
-		static int	CompareCallback( void *context, const void *a, const void *b );
+		int			GetGrowSize( int newSize ) const;
 
 		// ==============================================================================
-		//! Comparison callback
-		//!
-		//! @param	a	A pointer to the first object
-		//! @param	b	A pointer to the second object
+		//! Resize to the size and (optional) keep the content
 		//!
-		//! @return	0 if the objects match, otherwise positive or negative
-		// ==============================================================================
-		static int	CompareCallbackEx( void *context, const void *a, const void *b );
-
-		// ==============================================================================
-		//! Comparison data
-		// ==============================================================================
-		class CompareData {
-		public:
-			CompareData( cmpFunc_t f ) : func(f) {}
-
-			cmpFunc_t	func;		//!< The normal comparison function
-		};
-
-		// ==============================================================================
-		//! Comparison data with parameter
+		//! @param	newSize		The new list size
+		//! @param	keepContent	true to keep the content
 		// ==============================================================================
-		class CompareDataEx {
-		public:
-			CompareDataEx( cmpFuncEx_t f, void *p ) : func(f), param(p) {}
-
-			cmpFuncEx_t	func;		//!< The extended comparison function
-			void		*param;		//!< The parameter ( for the extended comparison )
-		};
+		void		Resize( int newSize, bool keepContent );
 	};
 
 	// ==============================================================================
@@ -275,6 +310,9 @@ namespace og {
 	//! @note	Everytime the list gets resized, it will create a new array of
 	//!			pointers to items and delete the old one. Since it just copies the pointer
 	//!			values and not the actual data, it is more efficient on big items.
+	//! @note	The items themselves are placed in blocks, which never move, so item
+	//!			addresses stay valid until the item gets removed. Removed items are
+	//!			reused by the next Alloc.
 	// ==============================================================================
 	template<class T>
 	class ListEx {
@@ -282,9 +320,9 @@ namespace og {
 		// ==============================================================================
 		//! Constructor
 		//!
-		//! @param	granularity	The granularity
+		//! @param	granularity	The granularity, 0 to grow by half of the current size
 		// ==============================================================================
-		ListEx( int granularity = 16 );
+		ListEx( int granularity = 0 );
 
 		// ==============================================================================
 		//! Copy Constructor
@@ -337,7 +375,7 @@ namespace og {
 		// ==============================================================================
 		//! Set the granularity
 		//!
-		//! @param	granularity	The new granularity
+		//! @param	granularity	The new granularity, 0 to grow by half of the current size
 		// ==============================================================================
 		void		SetGranularity( int granularity );
 
@@ -410,6 +448,23 @@ namespace og {
 		// ==============================================================================
 		void		SortEx( cmpFuncEx_t compare, void *param, bool removeDupes );
 
+		// ==============================================================================
+		//! Sort the list with a less functor and (optional) remove duplicates
+		//!
+		//! @param	less		Function or functor: bool less( const T &a, const T &b )
+		//! @param	removeDupes	true to remove duplicates
+		// ==============================================================================
+		template<class Less>
+		void		SortWith( Less less, bool removeDupes=false );
+
+		// ==============================================================================
+		//! Sort the list with a less functor and keep the order of equal items
+		//!
+		//! @param	less		Function or functor: bool less( const T &a, const T &b )
+		// ==============================================================================
+		template<class Less>
+		void		StableSortWith( Less less );
+
 		// ==============================================================================
 		//! Check if it needs resizing, and do it
 		//!
@@ -452,54 +507,55 @@ namespace og {
 		T **		list;			//<! Pointer to the list
 
 		// ==============================================================================
-		//! Resize to the size and (optional) keep the content
-		//!
-		//! @param	newSize		The new list size
-		//! @param	keepContent	true to keep the content
+		//! A block of items, the items follow the header
 		// ==============================================================================
-		void		Resize( int newSize, bool keepContent );
+		struct ItemBlock {
+			ItemBlock *	next;		//!< The previously allocated block
+		};
+		static const size_t BLOCK_HEADER_SIZE	= 16;	//!< Keeps the items 16 byte aligned
+		static const int	MIN_BLOCK_ITEMS		= 16;	//!< Items in the first block
+		static const int	MAX_BLOCK_ITEMS		= 512;	//!< Blocks don't grow beyond this
+
+		ItemBlock *	blocks;			//<! The newest block
+		int			blockUsed;		//<! Number of items used in the newest block
+		int			blockSize;		//<! Number of items in the newest block
+		void *		freeItems;		//<! Removed items, linked through their first bytes
 
 		// ==============================================================================
-		//! Comparison callback
+		//! Get the number of item pointers to allocate when the list needs to grow
 		//!
-		//! @param	a	A pointer to the first object
-		//! @param	b	A pointer to the second object
+		//! @param	newSize		The number of item pointers needed
 		//!
-		//! @return	0 if the objects match, otherwise positive or negative
+		//! @return	The new allocation size
 		// ==============================================================================
-		static int	CompareCallback( void *context, const void *a, const void *b );
+		int			GetGrowSize( int newSize ) const;
 
 		// ==============================================================================
-		//! Comparison callback
-		//!
-		//! @param	context	A pointer to the CompareData object
-		//! @param	a		A pointer to the first object
-		//! @param	b		A pointer to the second object
+		//! Resize to the size and (optional) keep the content
 		//!
-		//! @return	0 if the objects match, otherwise positive or negative
+		//! @param	newSize		The new list size
+		//! @param	keepContent	true to keep the content
 		// ==============================================================================
-		static int	CompareCallbackEx( void *context, const void *a, const void *b );
+		void		Resize( int newSize, bool keepContent );
 
 		// ==============================================================================
-		//! Comparison data
+		//! Construct a new item in the item blocks
+		//!
+		//! @return	Pointer to the new item
 		// ==============================================================================
-		class CompareData {
-		public:
-			CompareData( cmpFunc_t f ) : func(f) {}
-
-			cmpFunc_t	func;		//!< The normal comparison function
-		};
+		T *			NewItem( void );
 
 		// ==============================================================================
-		//! Comparison data with parameter
+		//! Destroy an item and keep its memory for reuse
+		//!
+		//! @param	item	The item to free
 		// ==============================================================================
-		class CompareDataEx {
-		public:
-			CompareDataEx( cmpFuncEx_t f, void *p ) : func(f), param(p) {}
+		void		FreeItem( T *item );
 
-			cmpFuncEx_t	func;		//!< The extended comparison function
-			void		*param;		//!< The parameter ( for the extended comparison )
-		};
+		// ==============================================================================
+		//! Get the memory size of one item in a block
+		// ==============================================================================
+		static size_t	ItemStride( void );
 	};
 
 	// ==============================================================================
@@ -510,9 +566,9 @@ namespace og {
 		// ==============================================================================
 		//! Constructor
 		//!
-		//! @param	granularity	The granularity
+		//! @param	granularity	The granularity, 0 to grow by half of the current size
 		// ==============================================================================
-		StringList( int granularity = 16 ) : ListEx<String>(granularity) {}
+		StringList( int granularity = 0 ) : ListEx<String>(granularity) {}
 
 		// ==============================================================================
 		//! Virtual Destructor
@@ -562,6 +618,22 @@ namespace og {
 		// ==============================================================================
 		void		operator+=( const char *value );
 	};
+
+	// ==============================================================================
+	//! Less functor for sorting strings, case sensitive
+	// ==============================================================================
+	class StringListLess {
+	public:
+		bool operator()( const String &a, const String &b ) const { return String::Cmp( a.c_str(), b.c_str() ) < 0; }
+	};
+
+	// ==============================================================================
+	//! Less functor for sorting strings, case insensitive
+	// ==============================================================================
+	class StringListILess {
+	public:
+		bool operator()( const String &a, const String &b ) const { return String::Icmp( a.c_str(), b.c_str() ) < 0; }
+	};
 //! @}
 }
 #endif
@@ -32,6 +32,59 @@ freely, subject to the following restrictions:
 
 namespace og {
 
+/*
+==============================================================================
+
+  RelocateItems
+
+==============================================================================
+*/
+template<class T, bool relocatable>
+class ItemRelocator {
+public:
+	static void Move( T *dest, T *src, int count ) {
+		for( int i=0; i<count; i++ ) {
+			new(&dest[i]) T( src[i] );
+			src[i].~T();
+		}
+	}
+};
+
+template<class T>
+class ItemRelocator<T, true> {
+public:
+	static void Move( T *dest, T *src, int count ) {
+		memcpy( dest, src, count * sizeof(T) );
+	}
+};
+
+/*
+================
+RelocateItems
+================
+*/
+template<class T>
+OG_INLINE void RelocateItems( T *dest, T *src, int count ) {
+	ItemRelocator<T, IsRelocatable<T>::value>::Move( dest, src, count );
+}
+
+/*
+================
+RelocateItems<String>
+
+Strings hand over their dynamic memory instead of copying it.
+================
+*/
+template<>
+OG_INLINE void RelocateItems<String>( String *dest, String *src, int count ) {
+	for( int i=0; i<count; i++ ) {
+		new(&dest[i]) String;
+		dest[i].SetAllocator( src[i].GetAllocator() );
+		src[i].MoveTo( dest[i] );
+		src[i].~String();
+	}
+}
+
 /*
 ==============================================================================
 
@@ -46,9 +99,10 @@ List::List
 ================
 */
 template<class T>
-OG_INLINE List<T>::List( int _granularity ) {
+OG_INLINE List<T>::List( int _granularity, MemoryAllocator *_allocator ) {
 	list		= NULL;
 	granularity = _granularity;
+	allocator	= _allocator;
 	Clear();
 }
 
@@ -60,6 +114,7 @@ List::List
 template<class T>
 OG_INLINE List<T>::List( const List<T> &other ) {
 	list = NULL;
+	allocator = NULL;
 	granularity = other.granularity;
 	Copy(other);
 }
@@ -81,7 +136,12 @@ List::Clear
 */
 template<class T>
 void List<T>::Clear( void ) {
-	SafeDeleteArray( list );
+	if ( list ) {
+		for ( int i=0; i<num; i++ )
+			list[i].~T();
+		MemFree( allocator, list, size * sizeof(T) );
+		list = NULL;
+	}
 	num		= 0;
 	size	= 0;
 }
@@ -138,6 +198,17 @@ OG_INLINE int List<T>::GetGranularity( void ) const {
 	return granularity;
 }
 
+/*
+================
+List::SetAllocator
+================
+*/
+template<class T>
+OG_INLINE void List<T>::SetAllocator( MemoryAllocator *_allocator ) {
+	Clear();
+	allocator = _allocator;
+}
+
 /*
 ================
 List::operator[]
@@ -175,8 +246,11 @@ copy all items from the other list.
 template<class T>
 void List<T>::Copy( const List<T> &other ) {
 	Clear();
-	for( int i=0; i<other.num; i++ )
-		Alloc() = other[i];
+	if ( other.num > 0 ) {
+		Resize( other.num, false );
+		for( ; num<other.num; num++ )
+			new(&list[num]) T( other.list[num] );
+	}
 }
 
 /*
@@ -216,8 +290,8 @@ in the list and resizes if needed.
 template<class T>
 T& List<T>::Alloc( void ) {
 	CheckSize( num+1 );
-	num++;
-	return list[num-1];
+	new(&list[num]) T;
+	return list[num++];
 }
 
 /*
@@ -229,7 +303,10 @@ template<class T>
 void List<T>::EnsureAllocated( int count, bool keepContent ) {
 	OG_ASSERT(count > 0);
 	CheckSize( count, keepContent );
-	num = count;
+	for( ; num<count; num++ )
+		new(&list[num]) T;
+	while( num>count )
+		list[--num].~T();
 }
 
 /*
@@ -239,7 +316,9 @@ List::Append
 */
 template<class T>
 OG_INLINE void List<T>::Append( T value ) {
-	Alloc() = value;
+	CheckSize( num+1 );
+	new(&list[num]) T( value );
+	num++;
 }
 
 /*
@@ -258,7 +337,7 @@ void List<T>::Remove( int index ) {
 		if ( (i+1) < num )
 			list[i] = list[i+1];
 	}
-	num--;
+	list[--num].~T();
 }
 
 /*
@@ -287,18 +366,7 @@ Sorts the list and removes duplicates.
 */
 template<class T>
 void List<T>::Sort( cmpFunc_t compare, bool removeDupes ) {
-	if ( num < 2 )
-		return;
-
-	CompareData cmpData( compare );
-	QuickSort( list, num, sizeof( T * ), &cmpData, CompareCallback );
-
-	if ( removeDupes ) {
-		for ( int i=num-2; i>=0; i-- ) {
-			if ( compare( list[i], list[i+1] ) == 0 )
-				Remove(i+1);
-		}
-	}
+	SortWith( CompareLess<T>( compare ), removeDupes );
 }
 
 /*
@@ -310,40 +378,53 @@ Sorts the list and removes duplicates.
 */
 template<class T>
 void List<T>::SortEx( cmpFuncEx_t compare, void *param, bool removeDupes ) {
+	SortWith( CompareLessEx<T>( compare, param ), removeDupes );
+}
+
+/*
+================
+List::SortWith
+================
+*/
+template<class T>
+template<class Less>
+void List<T>::SortWith( Less less, bool removeDupes ) {
 	if ( num < 2 )
 		return;
 
-	CompareDataEx cmpData( compare, param );
-	QuickSort( list, num, sizeof( T * ), &cmpData, CompareCallbackEx );
+	IntroSort( list, num, less );
 
 	if ( removeDupes ) {
-		for ( int i=num-2; i>=0; i-- ) {
-			if ( compare( list[i], list[i+1], param ) == 0 )
-				Remove(i+1);
-		}
+		int newNum = UniqueSorted( list, num, less );
+		while( num > newNum )
+			list[--num].~T();
 	}
 }
 
 /*
 ================
-List::CompareCallback
+List::StableSortWith
 ================
 */
 template<class T>
-int List<T>::CompareCallback( void *context, const void *a, const void *b ) {
-	CompareData *cmpData = reinterpret_cast<CompareData *>(context);
-	return cmpData->func( *(const T *)a, *(const T *)b );
+template<class Less>
+void List<T>::StableSortWith( Less less ) {
+	MergeSort( list, num, less );
 }
 
 /*
 ================
-ListEx::CompareCallbackEx
+List::GetGrowSize
+
+Rounds up to the granularity,
+or grows by half of the current size if there is none.
 ================
 */
 template<class T>
-int List<T>::CompareCallbackEx( void *context, const void *a, const void *b ) {
-	CompareDataEx *cmpData = reinterpret_cast<CompareDataEx *>(context);
-	return cmpData->func( *(const T *)a, *(const T *)b, cmpData->param );
+OG_INLINE int List<T>::GetGrowSize( int newSize ) const {
+	if ( granularity > 0 )
+		return ( (newSize + granularity - 1) / granularity ) * granularity;
+	return Max( newSize, Max( size + size / 2, 16 ) );
 }
 
 /*
@@ -351,26 +432,28 @@ int List<T>::CompareCallbackEx( void *context, const void *a, const void *b ) {
 List::Resize
 
 Create a new list with n items.
-(Checks for granularity)
-Copies all of the content if wanted.
+Only the used items get constructed,
+they get relocated if the content should be kept.
 Old list will be freed.
 ================
 */
 template<class T>
 void List<T>::Resize( int newSize, bool keepContent ) {
 	OG_ASSERT( newSize > 0 );
-	size = static_cast<int>( ceil( static_cast<float>(newSize)/static_cast<float>(granularity) ) ) * granularity;
+	int oldSize = size;
+	size = GetGrowSize( newSize );
 
-	T *newList = new T[ size ];
+	T *newList = static_cast<T *>( MemAlloc( allocator, size * sizeof(T) ) );
 
 	if ( list ) {
-		if ( keepContent ) {
+		if ( keepContent )
+			RelocateItems( newList, list, num );
+		else {
 			for ( int i=0; i<num; i++ )
-				newList[i] = list[i];
-		}
-		else
+				list[i].~T();
 			num = 0;
-		delete[] list;
+		}
+		MemFree( allocator, list, oldSize * sizeof(T) );
 	}
 	list = newList;
 }
@@ -391,6 +474,7 @@ ListEx::ListEx
 template<class T>
 OG_INLINE ListEx<T>::ListEx( int _granularity ) {
 	list		= NULL;
+	blocks		= NULL;
 	granularity = _granularity;
 	Clear();
 }
@@ -403,6 +487,7 @@ ListEx::ListEx
 template<class T>
 OG_INLINE ListEx<T>::ListEx( const ListEx<T> &other ) {
 	list = NULL;
+	blocks = NULL;
 	granularity = other.granularity;
 	Copy(other);
 }
@@ -428,12 +513,20 @@ template<class T>
 void ListEx<T>::Clear( void ) {
 	if ( list ) {
 		for ( int i=0; i<num; i++ )
-			delete list[i];
+			list[i]->~T();
 		delete[] list;
 		list = NULL;
 	}
-	num		= 0;
-	size	= 0;
+	while( blocks ) {
+		ItemBlock *next = blocks->next;
+		::operator delete( blocks );
+		blocks = next;
+	}
+	blockUsed	= 0;
+	blockSize	= 0;
+	freeItems	= NULL;
+	num			= 0;
+	size		= 0;
 }
 
 /*
@@ -569,7 +662,7 @@ in the list and resizes if needed.
 template<class T>
 T& ListEx<T>::Alloc( void ) {
 	CheckSize( num+1 );
-	list[num] = new T;
+	list[num] = NewItem();
 	return *list[num++];
 }
 
@@ -583,7 +676,7 @@ void ListEx<T>::EnsureAllocated( int count, bool keepContent ) {
 	OG_ASSERT(count > 0);
 	CheckSize( count, keepContent );
 	while( num<count )
-		list[num++] = new T;
+		list[num++] = NewItem();
 }
 
 /*
@@ -609,7 +702,7 @@ template<class T>
 void ListEx<T>::Remove( int index ) {
 	OG_ASSERT( index >= 0 && index < num );
 
-	delete list[index];
+	FreeItem( list[index] );
 	for ( int i=index; i<num; i++ ) {
 		if ( (i+1) < num )
 			list[i] = list[i+1];
@@ -643,18 +736,7 @@ Sorts the list and removes duplicates.
 */
 template<class T>
 void ListEx<T>::Sort( cmpFunc_t compare, bool removeDupes ) {
-	if ( num < 2 )
-		return;
-
-	CompareData cmpData( compare );
-	QuickSort( list, num, sizeof( T * ), &cmpData, CompareCallback );
-
-	if ( removeDupes ) {
-		for ( int i=num-2; i>=0; i-- ) {
-			if ( compare( *list[i], *list[i+1] ) == 0 )
-				Remove(i+1);
-		}
-	}
+	SortWith( CompareLess<T>( compare ), removeDupes );
 }
 
 /*
@@ -666,44 +748,62 @@ Sorts the list and removes duplicates.
 */
 template<class T>
 void ListEx<T>::SortEx( cmpFuncEx_t compare, void *param, bool removeDupes ) {
+	SortWith( CompareLessEx<T>( compare, param ), removeDupes );
+}
+
+/*
+================
+ListEx::SortWith
+
+Only the item pointers get sorted.
+================
+*/
+template<class T>
+template<class Less>
+void ListEx<T>::SortWith( Less less, bool removeDupes ) {
 	if ( num < 2 )
 		return;
 
-	CompareDataEx cmpData( compare, param );
-	QuickSort( list, num, sizeof( T * ), &cmpData, CompareCallbackEx );
+	IntroSort( list, num, PointerLess<T, Less>( less ) );
 
 	if ( removeDupes ) {
-		for ( int i=num-2; i>=0; i-- ) {
-			if ( compare( *list[i], *list[i+1], param ) == 0 )
-				Remove(i+1);
+		int last = 0;
+		for( int i=1; i<num; i++ ) {
+			if ( less( *list[last], *list[i] ) )
+				list[++last] = list[i];
+			else
+				FreeItem( list[i] );
 		}
+		for( int i=last+1; i<num; i++ )
+			list[i] = NULL;
+		num = last + 1;
 	}
 }
 
 /*
 ================
-ListEx::CompareCallback
+ListEx::StableSortWith
 ================
 */
 template<class T>
-int ListEx<T>::CompareCallback( void *context, const void *a, const void *b ) {
-	const T *pa = *(const T **)a;
-	const T *pb = *(const T **)b;
-	CompareData *cmpData = reinterpret_cast<CompareData *>(context);
-	return cmpData->func( *pa, *pb );
+template<class Less>
+void ListEx<T>::StableSortWith( Less less ) {
+	MergeSort( list, num, PointerLess<T, Less>( less ) );
 }
 
 /*
 ================
-ListEx::CompareCallbackEx
+ListEx::GetGrowSize
+
+Rounds up to the granularity,
+or grows by half of the current size if there is none.
 ================
 */
 template<class T>
-int ListEx<T>::CompareCallbackEx( void *context, const void *a, const void *b ) {
-	const T *pa = *(const T **)a;
-	const T *pb = *(const T **)b;
-	CompareDataEx *cmpData = reinterpret_cast<CompareDataEx *>(context);
-	return cmpData->func( *pa, *pb, cmpData->param );
+OG_INLINE int ListEx<T>::GetGrowSize( int newSize ) const {
+	if ( granularity > 0 )
+		return ( (newSize + granularity - 1) / granularity ) * granularity;
+	return Max( newSize, Max( size + size / 2, 16 ) );
 }
 
 /*
@@ -720,18 +820,16 @@ Old pointer list will be freed.
 template<class T>
 void ListEx<T>::Resize( int newSize, bool keepContent ) {
 	OG_ASSERT( newSize > 0 );
-	size = static_cast<int>( ceil( static_cast<float>(newSize)/static_cast<float>(granularity) ) ) * granularity;
+	size = GetGrowSize( newSize );
 
 	T **newList = new T *[ size ];
 
 	if ( list ) {
-		if ( keepContent ) {
-			for ( int i=0; i<num; i++ )
-				newList[i] = list[i];
-		}
+		if ( keepContent )
+			memcpy( newList, list, num * sizeof(T *) );
 		else {
 			for ( int i=0; i<num; i++ )
-				delete list[i];
+				FreeItem( list[i] );
 			num = 0;
 		}
 		delete[] list;
@@ -739,6 +837,63 @@ void ListEx<T>::Resize( int newSize, bool keepContent ) {
 	list = newList;
 }
 
+/*
+================
+ListEx::ItemStride
+
+Items need to be big enough to link them
+into the free list once they are removed.
+================
+*/
+template<class T>
+OG_INLINE size_t ListEx<T>::ItemStride( void ) {
+	return sizeof(T) < sizeof(void *) ? sizeof(void *) : sizeof(T);
+}
+
+/*
+================
+ListEx::NewItem
+
+Reuses a removed item if possible,
+otherwise takes the next one from the newest block.
+A new block gets allocated when that one is full.
+================
+*/
+template<class T>
+T *ListEx<T>::NewItem( void ) {
+	void *item;
+	if ( freeItems ) {
+		item = freeItems;
+		freeItems = *reinterpret_cast<void **>( item );
+	} else {
+		if ( blockUsed == blockSize ) {
+			if ( granularity > 0 )
+				blockSize = granularity;
+			else
+				blockSize = Min( Max( blockSize * 2, static_cast<int>(MIN_BLOCK_ITEMS) ), static_cast<int>(MAX_BLOCK_ITEMS) );
+			ItemBlock *block = static_cast<ItemBlock *>( ::operator new( BLOCK_HEADER_SIZE + blockSize * ItemStride() ) );
+			block->next = blocks;
+			blocks = block;
+			blockUsed = 0;
+		}
+		item = reinterpret_cast<byte *>( blocks ) + BLOCK_HEADER_SIZE + blockUsed * ItemStride();
+		blockUsed++;
+	}
+	return new(item) T;
+}
+
+/*
+================
+ListEx::FreeItem
+================
+*/
+template<class T>
+OG_INLINE void ListEx<T>::FreeItem( T *item ) {
+	item->~T();
+	*reinterpret_cast<void **>( item ) = freeItems;
+	freeItems = item;
+}
+
 /*
 ==============================================================================
 
@@ -0,0 +1,189 @@
+// ==============================================================================
+//! @file
+//! @brief	Slot map with stable handles
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+#ifndef __OG_SLOTMAP_H__
+#define __OG_SLOTMAP_H__
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Common Common (Library)
+//! @{
+
+	// ==============================================================================
+	//! Handle to an element of a SlotMap
+	//!
+	//! Stays valid until the element gets removed, a handle to a removed element
+	//! is detected as stale, even if its slot has been reused.
+	// ==============================================================================
+	class SlotHandle {
+	public:
+		// ==============================================================================
+		//! Default constructor, creates a null handle
+		// ==============================================================================
+		SlotHandle() : slot(-1), generation(0) {}
+
+		// ==============================================================================
+		//! Check if this is a null handle
+		//!
+		//! @return	true if the handle never pointed to an element
+		// ==============================================================================
+		bool	IsNull( void ) const { return slot == -1; }
+
+		bool	operator==( const SlotHandle &other ) const { return slot == other.slot && generation == other.generation; }
+		bool	operator!=( const SlotHandle &other ) const { return slot != other.slot || generation != other.generation; }
+
+	private:
+		template<class T> friend class SlotMap;
+
+		int		slot;		//!< The slot index
+		int		generation;	//!< The generation of the slot when the handle was created
+	};
+
+	// ==============================================================================
+	//! Slot map -> O(1) add and remove with stable handles
+	//!
+	//! Elements are kept in a dense array for fast iteration. Removing an element moves
+	//! the last one into its place, so indices change but handles don't.
+	//!
+	//! @note	Like with List, use pointers for big objects or objects that must not move
+	// ==============================================================================
+	template<class T>
+	class SlotMap {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	granularity	The granularity of the dense array, 0 to grow by half of the current size
+		// ==============================================================================
+		SlotMap( int granularity = 0 );
+
+		// ==============================================================================
+		//! Add an element
+		//!
+		//! @param	value	The element to add
+		//!
+		//! @return	The handle of the new element
+		// ==============================================================================
+		SlotHandle	Add( const T &value );
+
+		// ==============================================================================
+		//! Remove an element, the last element takes its index
+		//!
+		//! @param	handle	The handle of the element
+		//!
+		//! @return	false if the handle was stale
+		// ==============================================================================
+		bool		Remove( SlotHandle handle );
+
+		// ==============================================================================
+		//! Remove all elements, all handles become stale
+		// ==============================================================================
+		void		Clear( void );
+
+		// ==============================================================================
+		//! Get an element by handle
+		//!
+		//! @param	handle	The handle of the element
+		//!
+		//! @return	NULL if the handle is stale, otherwise a pointer to the element
+		//!
+		//! @note	The pointer is only valid until the next Add or Remove
+		// ==============================================================================
+		T *			Get( SlotHandle handle );
+		const T *	Get( SlotHandle handle ) const;
+
+		// ==============================================================================
+		//! Check if a handle points to an element
+		//!
+		//! @param	handle	The handle
+		//!
+		//! @return	false if the handle is null or stale
+		// ==============================================================================
+		bool		IsValid( SlotHandle handle ) const;
+
+		// ==============================================================================
+		//! Get the index of an element in the dense array
+		//!
+		//! @param	handle	The handle of the element
+		//!
+		//! @return	-1 if the handle is stale, otherwise the index
+		// ==============================================================================
+		int			GetIndex( SlotHandle handle ) const;
+
+		// ==============================================================================
+		//! Get the handle of an element in the dense array
+		//!
+		//! @param	index	The index
+		//!
+		//! @return	The handle
+		// ==============================================================================
+		SlotHandle	GetHandle( int index ) const;
+
+		// ==============================================================================
+		//! Check if there are no elements
+		//!
+		//! @return	true if empty, false if not
+		// ==============================================================================
+		bool		IsEmpty( void ) const;
+
+		// ==============================================================================
+		//! Get the number of elements
+		//!
+		//! @return	The number of elements
+		// ==============================================================================
+		int			Num( void ) const;
+
+		// ==============================================================================
+		//! Get an element by index in the dense array
+		//!
+		//! @param	index	The index, 0 to Num()-1
+		//!
+		//! @return	Reference to the element
+		// ==============================================================================
+		T &			operator[]( int index );
+		const T &	operator[]( int index ) const;
+
+	private:
+		// ==============================================================================
+		//! A slot, maps handles to the dense array
+		// ==============================================================================
+		struct Slot {
+			int		generation;	//!< Increased on every remove, so old handles become stale
+			int		index;		//!< The index in the dense array, or the next free slot if unused
+		};
+
+		List<T>		values;		//!< The elements
+		List<int>	valueSlots;	//!< The slot of each element
+		List<Slot>	slots;		//!< The slots
+		int			freeSlot;	//!< The first unused slot, -1 if none
+	};
+//! @}
+}
+
+#endif
@@ -0,0 +1,214 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Slot map with stable handles
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#ifndef __OG_SLOTMAP_INL__
+#define __OG_SLOTMAP_INL__
+
+namespace og {
+
+/*
+==============================================================================
+
+  SlotMap
+
+==============================================================================
+*/
+
+/*
+================
+SlotMap::SlotMap
+================
+*/
+template<class T>
+OG_INLINE SlotMap<T>::SlotMap( int granularity ) : values(granularity), valueSlots(granularity), slots(granularity) {
+	freeSlot = -1;
+}
+
+/*
+================
+SlotMap::Add
+================
+*/
+template<class T>
+OG_INLINE SlotHandle SlotMap<T>::Add( const T &value ) {
+	int slotIndex = freeSlot;
+	if ( slotIndex != -1 )
+		freeSlot = slots[slotIndex].index;
+	else {
+		slotIndex = slots.Num();
+		slots.Alloc().generation = 0;
+	}
+
+	Slot &slot = slots[slotIndex];
+	slot.index = values.Num();
+	values.Append( value );
+	valueSlots.Append( slotIndex );
+
+	SlotHandle handle;
+	handle.slot = slotIndex;
+	handle.generation = slot.generation;
+	return handle;
+}
+
+/*
+================
+SlotMap::Remove
+================
+*/
+template<class T>
+OG_INLINE bool SlotMap<T>::Remove( SlotHandle handle ) {
+	int index = GetIndex( handle );
+	if ( index == -1 )
+		return false;
+
+	// move the last element into the gap
+	int last = values.Num() - 1;
+	if ( index != last ) {
+		values[index] = values[last];
+		valueSlots[index] = valueSlots[last];
+		slots[valueSlots[index]].index = index;
+	}
+	values.Remove( last );
+	valueSlots.Remove( last );
+
+	Slot &slot = slots[handle.slot];
+	slot.generation++;
+	slot.index = freeSlot;
+	freeSlot = handle.slot;
+	return true;
+}
+
+/*
+================
+SlotMap::Clear
+================
+*/
+template<class T>
+OG_INLINE void SlotMap<T>::Clear( void ) {
+	int num = valueSlots.Num();
+	for( int i=0; i<num; i++ ) {
+		Slot &slot = slots[valueSlots[i]];
+		slot.generation++;
+		slot.index = freeSlot;
+		freeSlot = valueSlots[i];
+	}
+	values.Clear();
+	valueSlots.Clear();
+}
+
+/*
+================
+SlotMap::Get
+================
+*/
+template<class T>
+OG_INLINE T *SlotMap<T>::Get( SlotHandle handle ) {
+	int index = GetIndex( handle );
+	return index != -1 ? &values[index] : NULL;
+}
+template<class T>
+OG_INLINE const T *SlotMap<T>::Get( SlotHandle handle ) const {
+	int index = GetIndex( handle );
+	return index != -1 ? &values[index] : NULL;
+}
+
+/*
+================
+SlotMap::IsValid
+================
+*/
+template<class T>
+OG_INLINE bool SlotMap<T>::IsValid( SlotHandle handle ) const {
+	return GetIndex( handle ) != -1;
+}
+
+/*
+================
+SlotMap::GetIndex
+================
+*/
+template<class T>
+OG_INLINE int SlotMap<T>::GetIndex( SlotHandle handle ) const {
+	if ( handle.slot < 0 || handle.slot >= slots.Num() )
+		return -1;
+	const Slot &slot = slots[handle.slot];
+	return slot.generation == handle.generation ? slot.index : -1;
+}
+
+/*
+================
+SlotMap::GetHandle
+================
+*/
+template<class T>
+OG_INLINE SlotHandle SlotMap<T>::GetHandle( int index ) const {
+	OG_ASSERT( index >= 0 && index < values.Num() );
+	SlotHandle handle;
+	handle.slot = valueSlots[index];
+	handle.generation = slots[handle.slot].generation;
+	return handle;
+}
+
+/*
+================
+SlotMap::IsEmpty
+================
+*/
+template<class T>
+OG_INLINE bool SlotMap<T>::IsEmpty( void ) const {
+	return values.IsEmpty();
+}
+
+/*
+================
+SlotMap::Num
+================
+*/
+template<class T>
+OG_INLINE int SlotMap<T>::Num( void ) const {
+	return values.Num();
+}
+
+/*
+================
+SlotMap::operator[]
+================
+*/
+template<class T>
+OG_INLINE T &SlotMap<T>::operator[]( int index ) {
+	return values[index];
+}
+template<class T>
+OG_INLINE const T &SlotMap<T>::operator[]( int index ) const {
+	return values[index];
+}
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+// ==============================================================================
+//! @file
+//! @brief	Sorting algorithms working on arrays
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+
+#ifndef __OG_SORT_H__
+#define __OG_SORT_H__
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Common Common (Library)
+//! @{
+
+	// ==============================================================================
+	//! Sort an array ( not stable )
+	//!
+	//! Introsort: quicksort with a median of three pivot, which switches to heapsort
+	//! if the recursion gets too deep and to insertion sort for small ranges.
+	//!
+	//! @param	data	The array to sort
+	//! @param	num		The number of items
+	//! @param	less	Function or functor: bool less( const T &a, const T &b )
+	// ==============================================================================
+	template<class T, class Less>
+	void	IntroSort( T *data, int num, Less less );
+
+	// ==============================================================================
+	//! Sort an array and keep the order of equal items ( stable )
+	//!
+	//! Mergesort, needs a temporary buffer for half of the items.
+	//!
+	//! @param	data	The array to sort
+	//! @param	num		The number of items
+	//! @param	less	Function or functor: bool less( const T &a, const T &b )
+	// ==============================================================================
+	template<class T, class Less>
+	void	MergeSort( T *data, int num, Less less );
+
+	// ==============================================================================
+	//! Move the first of each group of equal items to the front of a sorted array
+	//!
+	//! @param	data	The sorted array
+	//! @param	num		The number of items
+	//! @param	less	The function or functor used to sort the array
+	//!
+	//! @return	The number of unique items, the items behind them are left over
+	// ==============================================================================
+	template<class T, class Less>
+	int		UniqueSorted( T *data, int num, Less less );
+
+	// ==============================================================================
+	//! Turns a comparison function ( returning <0, 0 or >0 ) into a less functor
+	// ==============================================================================
+	template<class T>
+	class CompareLess {
+	public:
+		typedef int ( *cmpFunc_t )( const T &a, const T &b );
+
+		CompareLess( cmpFunc_t f ) : func(f) {}
+		bool operator()( const T &a, const T &b ) const { return func( a, b ) < 0; }
+
+	private:
+		cmpFunc_t	func;		//!< The comparison function
+	};
+
+	// ==============================================================================
+	//! Turns a comparison function with an extra parameter into a less functor
+	// ==============================================================================
+	template<class T>
+	class CompareLessEx {
+	public:
+		typedef int ( *cmpFuncEx_t )( const T &a, const T &b, void *param );
+
+		CompareLessEx( cmpFuncEx_t f, void *p ) : func(f), param(p) {}
+		bool operator()( const T &a, const T &b ) const { return func( a, b, param ) < 0; }
+
+	private:
+		cmpFuncEx_t	func;		//!< The comparison function
+		void *		param;		//!< The parameter to pass to it
+	};
+
+	// ==============================================================================
+	//! Compares the objects behind pointers with another less functor
+	// ==============================================================================
+	template<class T, class Less>
+	class PointerLess {
+	public:
+		PointerLess( Less l ) : less(l) {}
+		bool operator()( const T *a, const T *b ) const { return less( *a, *b ); }
+
+	private:
+		Less	less;		//!< The functor for the objects
+	};
+
+//! @}
+}
+
+#endif
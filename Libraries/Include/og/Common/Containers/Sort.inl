@@ -0,0 +1,287 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Sorting algorithms working on arrays
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#ifndef __OG_SORT_INL__
+#define __OG_SORT_INL__
+
+namespace og {
+
+const int SORT_INSERTION_THRESHOLD = 16;	// ranges up to this size are done with insertion sort
+
+/*
+================
+SortSwap
+================
+*/
+template<class T>
+OG_INLINE void SortSwap( T &a, T &b ) {
+	T temp = a;
+	a = b;
+	b = temp;
+}
+
+/*
+================
+InsertionSort
+
+Stable, fast on small or nearly sorted ranges.
+================
+*/
+template<class T, class Less>
+void InsertionSort( T *data, int num, Less less ) {
+	for( int i=1; i<num; i++ ) {
+		if ( !less( data[i], data[i-1] ) )
+			continue;
+		T value = data[i];
+		int j = i;
+		do {
+			data[j] = data[j-1];
+			j--;
+		} while( j > 0 && less( value, data[j-1] ) );
+		data[j] = value;
+	}
+}
+
+/*
+================
+HeapSiftDown
+================
+*/
+template<class T, class Less>
+void HeapSiftDown( T *data, int root, int num, Less less ) {
+	T value = data[root];
+	for(;;) {
+		int child = root * 2 + 1;
+		if ( child >= num )
+			break;
+		if ( child + 1 < num && less( data[child], data[child+1] ) )
+			child++;
+		if ( !less( value, data[child] ) )
+			break;
+		data[root] = data[child];
+		root = child;
+	}
+	data[root] = value;
+}
+
+/*
+================
+HeapSort
+================
+*/
+template<class T, class Less>
+void HeapSort( T *data, int num, Less less ) {
+	for( int i=num/2-1; i>=0; i-- )
+		HeapSiftDown( data, i, num, less );
+	for( int end=num-1; end>0; end-- ) {
+		SortSwap( data[0], data[end] );
+		HeapSiftDown( data, 0, end, less );
+	}
+}
+
+/*
+================
+MoveMedianToFirst
+
+Moves the median of data[a], data[b] and data[c] to data[0]
+================
+*/
+template<class T, class Less>
+OG_INLINE void MoveMedianToFirst( T *data, int a, int b, int c, Less less ) {
+	if ( less( data[a], data[b] ) ) {
+		if ( less( data[b], data[c] ) )
+			SortSwap( data[0], data[b] );
+		else if ( less( data[a], data[c] ) )
+			SortSwap( data[0], data[c] );
+		else
+			SortSwap( data[0], data[a] );
+	}
+	else if ( less( data[a], data[c] ) )
+		SortSwap( data[0], data[a] );
+	else if ( less( data[b], data[c] ) )
+		SortSwap( data[0], data[c] );
+	else
+		SortSwap( data[0], data[b] );
+}
+
+/*
+================
+UnguardedPartition
+
+Partitions data[1..num-1] around the pivot in data[0].
+The median of three guarantees that both scans stop inside the array.
+================
+*/
+template<class T, class Less>
+int UnguardedPartition( T *data, int num, Less less ) {
+	int i = 1;
+	int j = num;
+	for(;;) {
+		while( less( data[i], data[0] ) )
+			i++;
+		j--;
+		while( less( data[0], data[j] ) )
+			j--;
+		if ( i >= j )
+			return i;
+		SortSwap( data[i], data[j] );
+		i++;
+	}
+}
+
+/*
+================
+IntroSortLoop
+
+Leaves ranges up to SORT_INSERTION_THRESHOLD unsorted,
+the final insertion sort takes care of them.
+================
+*/
+template<class T, class Less>
+void IntroSortLoop( T *data, int num, int depthLimit, Less less ) {
+	while( num > SORT_INSERTION_THRESHOLD ) {
+		if ( depthLimit == 0 ) {
+			HeapSort( data, num, less );
+			return;
+		}
+		depthLimit--;
+
+		MoveMedianToFirst( data, 1, num / 2, num - 1, less );
+		int cut = UnguardedPartition( data, num, less );
+
+		// recurse into the smaller part, so the stack stays small
+		if ( cut < num - cut ) {
+			IntroSortLoop( data, cut, depthLimit, less );
+			data += cut;
+			num -= cut;
+		} else {
+			IntroSortLoop( data + cut, num - cut, depthLimit, less );
+			num = cut;
+		}
+	}
+}
+
+/*
+================
+IntroSort
+================
+*/
+template<class T, class Less>
+void IntroSort( T *data, int num, Less less ) {
+	if ( num < 2 )
+		return;
+
+	int depthLimit = 0;
+	for( int n=num; n>1; n >>= 1 )
+		depthLimit += 2;
+	IntroSortLoop( data, num, depthLimit, less );
+	InsertionSort( data, num, less );
+}
+
+/*
+================
+MergeSortRange
+
+Sorts both halves, then merges them,
+with the left half copied to the buffer.
+================
+*/
+template<class T, class Less>
+void MergeSortRange( T *data, int num, T *buffer, Less less ) {
+	if ( num <= SORT_INSERTION_THRESHOLD ) {
+		InsertionSort( data, num, less );
+		return;
+	}
+
+	int half = num / 2;
+	MergeSortRange( data, half, buffer, less );
+	MergeSortRange( data + half, num - half, buffer, less );
+
+	// already in order
+	if ( !less( data[half], data[half-1] ) )
+		return;
+
+	for( int i=0; i<half; i++ )
+		buffer[i] = data[i];
+
+	// take from the left half on equal items, to keep it stable
+	int i = 0, j = half, k = 0;
+	while( i < half && j < num ) {
+		if ( less( data[j], buffer[i] ) )
+			data[k++] = data[j++];
+		else
+			data[k++] = buffer[i++];
+	}
+	while( i < half )
+		data[k++] = buffer[i++];
+}
+
+/*
+================
+MergeSort
+================
+*/
+template<class T, class Less>
+void MergeSort( T *data, int num, Less less ) {
+	if ( num < 2 )
+		return;
+	if ( num <= SORT_INSERTION_THRESHOLD ) {
+		InsertionSort( data, num, less );
+		return;
+	}
+
+	T *buffer = new T[num / 2];
+	MergeSortRange( data, num, buffer, less );
+	delete[] buffer;
+}
+
+/*
+================
+UniqueSorted
+================
+*/
+template<class T, class Less>
+int UniqueSorted( T *data, int num, Less less ) {
+	if ( num < 2 )
+		return num;
+
+	int last = 0;
+	for( int i=1; i<num; i++ ) {
+		if ( less( data[last], data[i] ) ) {
+			last++;
+			if ( last != i )
+				data[last] = data[i];
+		}
+	}
+	return last + 1;
+}
+
+}
+
+#endif
@@ -30,12 +30,15 @@
 #ifndef __OG_STRINGPOOL_H__
 #define __OG_STRINGPOOL_H__
 
+#include <og/Common/Thread/Atomic.h>
+
 //! Open Game Libraries
 namespace og {
 //! @defgroup Common Common (Library)
 //! @{
 
 	class StringPool;
+	class SharedStringPool;
 
 	// ==============================================================================
 	//! Pool string
@@ -45,29 +48,38 @@ namespace og {
 	class PoolString : public String {
 	public:
 		friend class StringPool;
+		friend class SharedStringPool;
 
 		// ==============================================================================
 		//! Constructor
 		// ==============================================================================
-		PoolString() { inUse = 0; }
+		PoolString() {}
 
 		// ==============================================================================
 		//! Initialize this object
 		//!
 		//! @param	pool	The parent StringPool
 		//! @param	value	The string value
+		//! @param	hash	The case insensitive hash of value
 		// ==============================================================================
-		void Init( StringPool *pool, const char *value ) {
-			inUse = 1;
+		void Init( StringPool *pool, const StringView &value, int hash ) {
+			inUse.Set( 1 );
 			this->pool = pool;
-			size_t byteLen, len;
-			BothLengths( value, &byteLen, &len );
-			SetData( value, byteLen, len );
+			this->hash = hash;
+			String::operator=( value );
 		}
 
+		// ==============================================================================
+		//! Get the case insensitive hash, same as HashIndex::GenerateKey( c_str(), false )
+		//!
+		//! @return	The hash
+		// ==============================================================================
+		int		GetHash( void ) const { return hash; }
+
 	private:
-		StringPool *	pool;	//!< The parent pool
-		mutable int		inUse;	//!< How many times this object is in use
+		StringPool *		pool;	//!< The parent pool
+		int					hash;	//!< The case insensitive hash
+		mutable AtomicInt	inUse;	//!< How many times this object is in use
 	};
 
 	// ==============================================================================
@@ -110,7 +122,7 @@ namespace og {
 		//!
 		//! @return	The string object
 		// ==============================================================================
-		const PoolString *	Alloc( const char *value );
+		const PoolString *	Alloc( const StringView &value );
 
 		// ==============================================================================
 		//! Free the poolstring, automaticly destroy the string object if not in use anymore
@@ -133,6 +145,142 @@ namespace og {
 		HashIndex			hashIndex;		//!< Hash index
 		bool				caseSensitive;	//!< true to be case sensitive
 	};
+
+	// ==============================================================================
+	//! Thread-safe string pool
+	//!
+	//! Strings are spread over several StringPool stripes by their hash,
+	//! each stripe has its own lock, so threads interning different strings rarely wait on each other.
+	//! A PoolString from this pool may be copied and freed on any thread.
+	// ==============================================================================
+	class SharedStringPool {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	caseSensitive	true to make it case sensitive
+		// ==============================================================================
+		SharedStringPool( bool caseSensitive = true );
+		~SharedStringPool();
+
+		// ==============================================================================
+		//! Get the number of entries
+		//!
+		//! @return	The current number of entries
+		// ==============================================================================
+		int			Num( void ) const;
+
+		// ==============================================================================
+		//! Returns the matching string object to the value, or a new one if no match exists
+		//!
+		//! @param	value	The string value
+		//!
+		//! @return	The string object
+		// ==============================================================================
+		const PoolString *	Alloc( const StringView &value );
+
+		// ==============================================================================
+		//! Free the poolstring, automaticly destroy the string object if not in use anymore
+		//!
+		//! @param	poolStr	The string object
+		// ==============================================================================
+		void				Free( const PoolString *poolStr );
+
+		// ==============================================================================
+		//! Same as Alloc, but takes an existing PoolString
+		//!
+		//! @param	poolStr	The pool string
+		//!
+		//! @return	The string object
+		// ==============================================================================
+		const PoolString *	Copy( const PoolString *poolStr );
+
+	private:
+		struct Stripe;
+		static const int STRIPE_BITS = 4;
+		static const int NUM_STRIPES = 1 << STRIPE_BITS;
+
+		// ==============================================================================
+		//! Get the stripe responsible for a value
+		// ==============================================================================
+		Stripe &			GetStripe( const StringView &value ) const;
+
+		// ==============================================================================
+		//! Check if a PoolString belongs to one of the stripes
+		// ==============================================================================
+		bool				IsOwner( const PoolString *poolStr ) const;
+
+		Stripe *			stripes;		//!< The stripes
+		bool				caseSensitive;	//!< true to be case sensitive
+
+		// not copyable
+		SharedStringPool( const SharedStringPool & );
+		SharedStringPool &operator=( const SharedStringPool & );
+	};
+
+	// ==============================================================================
+	//! Interned string handle
+	//!
+	//! All Names share one global SharedStringPool, so two Names with the same text
+	//! point to the same PoolString. Comparing them is a pointer compare ( case sensitive )
+	//! and the case insensitive hash is computed only once, when the text gets interned.
+	//! Create Names for keys you look up often and keep them around.
+	// ==============================================================================
+	class Name {
+	public:
+		// ==============================================================================
+		//! Constructors
+		//!
+		//! @param	value	The text, NULL or "" create an empty Name
+		// ==============================================================================
+		Name() : str(NULL) {}
+		explicit Name( const char *value );
+		Name( const Name &other );
+		~Name();
+
+		// ==============================================================================
+		//! Get the text
+		//!
+		//! @return	The text, "" for an empty Name
+		// ==============================================================================
+		const char *		c_str( void ) const { return str ? str->c_str() : ""; }
+
+		// ==============================================================================
+		//! Get the case insensitive hash, same as HashIndex::GenerateKey( c_str(), false )
+		//!
+		//! @return	The hash
+		// ==============================================================================
+		int					GetHash( void ) const;
+
+		// ==============================================================================
+		//! Get the interned string
+		//!
+		//! @return	The PoolString, NULL for an empty Name
+		// ==============================================================================
+		const PoolString *	GetPoolString( void ) const { return str; }
+
+		// ==============================================================================
+		//! Check if this Name is empty
+		//!
+		//! @return	true if it has no text
+		// ==============================================================================
+		bool				IsEmpty( void ) const { return str == NULL; }
+
+		// ==============================================================================
+		//! Get the pool all Names are stored in
+		//!
+		//! @return	The pool, it stays alive until the program ends
+		// ==============================================================================
+		static SharedStringPool &GetPool( void );
+
+	// operators
+		Name &				operator=( const Name &other );
+		bool				operator==( const Name &other ) const { return str == other.str; }
+		bool				operator!=( const Name &other ) const { return str != other.str; }
+
+	private:
+		const PoolString *	str;	//!< The interned string
+	};
 //! @}
 }
 
@@ -0,0 +1,283 @@
+// ==============================================================================
+//! @file
+//! @brief	Atomic integer and pointer helpers
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+#ifndef __OG_ATOMIC_H__
+#define __OG_ATOMIC_H__
+
+#include <og/Setup.h>
+
+#if OG_ASM_MSVC
+	#include <intrin.h>
+	#pragma intrinsic( _InterlockedIncrement, _InterlockedDecrement, _InterlockedExchangeAdd )
+	#pragma intrinsic( _InterlockedExchange, _InterlockedCompareExchange, _ReadWriteBarrier )
+	#ifdef _WIN64
+		#pragma intrinsic( _InterlockedExchange64, _InterlockedCompareExchange64 )
+	#endif
+#endif
+
+//! Size of a cache line, used to pad data that gets written by different threads
+#define OG_CACHE_LINE_SIZE 64
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Common Common (Library)
+//! @{
+
+	// ==============================================================================
+	//! Prevent the compiler from reordering memory accesses across this call
+	// ==============================================================================
+	OG_INLINE void CompilerFence( void ) {
+#if OG_ASM_MSVC
+		_ReadWriteBarrier();
+#else
+		__asm__ __volatile__( "" ::: "memory" );
+#endif
+	}
+
+	// ==============================================================================
+	//! Full memory fence, neither the compiler nor the cpu may reorder across it
+	// ==============================================================================
+	OG_INLINE void MemoryFence( void ) {
+#if OG_ASM_MSVC
+		long dummy;
+		_InterlockedExchange( &dummy, 0 );
+#else
+		__sync_synchronize();
+#endif
+	}
+
+	// ==============================================================================
+	//! Tell the cpu we are in a spin-wait loop
+	// ==============================================================================
+	OG_INLINE void CpuPause( void ) {
+#if OG_ASM_MSVC
+		_mm_pause();
+#else
+		__asm__ __volatile__( "pause" ::: "memory" );
+#endif
+	}
+
+	// ==============================================================================
+	//! Atomic integer
+	//!
+	//! All read-modify-write operations are full memory barriers.
+	//! Get() and Set() only prevent compiler reordering, which is enough for x86 loads and stores.
+	// ==============================================================================
+	class AtomicInt {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	initial	The initial value
+		// ==============================================================================
+		AtomicInt( int initial=0 ) : value(initial) {}
+
+		// ==============================================================================
+		//! Read the value
+		//!
+		//! @return	The current value
+		// ==============================================================================
+		int		Get( void ) const {
+			int result = value;
+			CompilerFence();
+			return result;
+		}
+
+		// ==============================================================================
+		//! Write the value
+		//!
+		//! @param	newValue	The new value
+		// ==============================================================================
+		void	Set( int newValue ) {
+			CompilerFence();
+			value = newValue;
+		}
+
+		// ==============================================================================
+		//! Increment the value by one
+		//!
+		//! @return	The incremented value
+		// ==============================================================================
+		int		Increment( void ) {
+#if OG_ASM_MSVC
+			return _InterlockedIncrement( &value );
+#else
+			return __sync_add_and_fetch( &value, 1 );
+#endif
+		}
+
+		// ==============================================================================
+		//! Decrement the value by one
+		//!
+		//! @return	The decremented value
+		// ==============================================================================
+		int		Decrement( void ) {
+#if OG_ASM_MSVC
+			return _InterlockedDecrement( &value );
+#else
+			return __sync_sub_and_fetch( &value, 1 );
+#endif
+		}
+
+		// ==============================================================================
+		//! Add to the value
+		//!
+		//! @param	amount	The amount to add ( can be negative )
+		//!
+		//! @return	The new value
+		// ==============================================================================
+		int		Add( int amount ) {
+#if OG_ASM_MSVC
+			return _InterlockedExchangeAdd( &value, amount ) + amount;
+#else
+			return __sync_add_and_fetch( &value, amount );
+#endif
+		}
+
+		// ==============================================================================
+		//! Set a new value
+		//!
+		//! @param	newValue	The new value
+		//!
+		//! @return	The previous value
+		// ==============================================================================
+		int		Exchange( int newValue ) {
+#if OG_ASM_MSVC
+			return _InterlockedExchange( &value, newValue );
+#else
+			return __sync_lock_test_and_set( &value, newValue );
+#endif
+		}
+
+		// ==============================================================================
+		//! Set a new value if the current value equals comparand
+		//!
+		//! @param	newValue	The new value
+		//! @param	comparand	The value to compare with
+		//!
+		//! @return	The previous value, the exchange succeeded if this equals comparand
+		// ==============================================================================
+		int		CompareExchange( int newValue, int comparand ) {
+#if OG_ASM_MSVC
+			return _InterlockedCompareExchange( &value, newValue, comparand );
+#else
+			return __sync_val_compare_and_swap( &value, comparand, newValue );
+#endif
+		}
+
+	private:
+#if OG_ASM_MSVC
+		volatile long	value;	//!< The value
+#else
+		volatile int	value;	//!< The value
+#endif
+	};
+
+	// ==============================================================================
+	//! Atomic pointer
+	//!
+	//! @see	AtomicInt
+	// ==============================================================================
+	template<typename type>
+	class AtomicPtr {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	initial	The initial value
+		// ==============================================================================
+		AtomicPtr( type *initial=NULL ) : value(initial) {}
+
+		// ==============================================================================
+		//! Read the pointer
+		//!
+		//! @return	The current pointer
+		// ==============================================================================
+		type *	Get( void ) const {
+			type *result = value;
+			CompilerFence();
+			return result;
+		}
+
+		// ==============================================================================
+		//! Write the pointer
+		//!
+		//! @param	newValue	The new pointer
+		// ==============================================================================
+		void	Set( type *newValue ) {
+			CompilerFence();
+			value = newValue;
+		}
+
+		// ==============================================================================
+		//! Set a new pointer
+		//!
+		//! @param	newValue	The new pointer
+		//!
+		//! @return	The previous pointer
+		// ==============================================================================
+		type *	Exchange( type *newValue ) {
+#if OG_ASM_MSVC
+	#ifdef _WIN64
+			return (type *)_InterlockedExchange64( (volatile __int64 *)&value, (__int64)newValue );
+	#else
+			return (type *)_InterlockedExchange( (volatile long *)&value, (long)newValue );
+	#endif
+#else
+			return __sync_lock_test_and_set( &value, newValue );
+#endif
+		}
+
+		// ==============================================================================
+		//! Set a new pointer if the current pointer equals comparand
+		//!
+		//! @param	newValue	The new pointer
+		//! @param	comparand	The pointer to compare with
+		//!
+		//! @return	The previous pointer, the exchange succeeded if this equals comparand
+		// ==============================================================================
+		type *	CompareExchange( type *newValue, type *comparand ) {
+#if OG_ASM_MSVC
+	#ifdef _WIN64
+			return (type *)_InterlockedCompareExchange64( (volatile __int64 *)&value, (__int64)newValue, (__int64)comparand );
+	#else
+			return (type *)_InterlockedCompareExchange( (volatile long *)&value, (long)newValue, (long)comparand );
+	#endif
+#else
+			return __sync_val_compare_and_swap( &value, comparand, newValue );
+#endif
+		}
+
+	private:
+		type * volatile	value;	//!< The pointer
+	};
+//! @}
+}
+
+#endif
@@ -30,7 +30,10 @@
 #ifndef __OG_EVENT_QUEUE_H__
 #define __OG_EVENT_QUEUE_H__
 
+#include <og/Common.h>
 #include <og/Common/Thread/LockFreeQueue.h>
+#include <og/Common/Thread/ObjectPool.h>
+#include <og/Common/Thread/RingQueue.h>
 
 //! Open Game Libraries
 namespace og {
@@ -39,9 +42,13 @@ namespace og {
 
 	// ==============================================================================
 	//! A queued event
+	//!
+	//! @note	Events are allocated from the ObjectPool
 	// ==============================================================================
 	class QueuedEvent {
 	public:
+		OG_POOLED_OBJECT
+
 		// ==============================================================================
 		//! Virtual Destructor
 		// ==============================================================================
@@ -51,17 +58,116 @@ namespace og {
 		//! Execute your event in here
 		// ==============================================================================
 		virtual void Execute( void ) = 0;
+
+		// ==============================================================================
+		//! Get the key for coalescing batched events
+		//!
+		//! Within a batch, an event replaces an earlier one with the same key.
+		//!
+		//! @param	object	Set this to the object the event changes
+		//! @param	type	Set this to the property the event changes
+		//!
+		//! @return	false if the event must not be coalesced ( default )
+		// ==============================================================================
+		virtual bool GetCoalesceKey( const void *&/*object*/, int &/*type*/ ) const { return false; }
+	};
+
+	// ==============================================================================
+	//! A batch of events, executed in the order they have been appended
+	//!
+	//! Each thread has its own open batches, one per queue, see EventQueueEx::BeginBatch.
+	// ==============================================================================
+	class EventBatch : public QueuedEvent {
+	public:
+		// ==============================================================================
+		//! Destructor, deletes the events that have not been executed
+		// ==============================================================================
+		~EventBatch();
+
+		// ==============================================================================
+		//! Execute and delete all events
+		// ==============================================================================
+		void	Execute( void );
+
+		// ==============================================================================
+		//! Open a batch for the calling thread, or increase the nesting depth of an open one
+		//!
+		//! @param	queue	The queue the batch belongs to
+		// ==============================================================================
+		static void	Begin( const void *queue );
+
+		// ==============================================================================
+		//! Close the batch of the calling thread, once the nesting depth reaches zero
+		//!
+		//! @param	queue	The queue the batch belongs to
+		//!
+		//! @return	The batch if it was closed and has events, otherwise NULL
+		// ==============================================================================
+		static EventBatch *	End( const void *queue );
+
+		// ==============================================================================
+		//! Append an event to the open batch of the calling thread
+		//!
+		//! If an event with the same coalesce key is already in the batch,
+		//! it gets deleted and the new one takes its place.
+		//!
+		//! @param	queue	The queue the batch belongs to
+		//! @param	evt		The event to append
+		//!
+		//! @return	false if there is no open batch for this queue
+		//! @see	QueuedEvent::GetCoalesceKey
+		// ==============================================================================
+		static bool	Append( const void *queue, QueuedEvent *evt );
+
+	private:
+		friend class EventBatchList;
+		EventBatch( const void *_queue ) : queue(_queue), depth(1), nextOpen(NULL) {}
+
+		void	AppendEvent( QueuedEvent *evt );
+
+		struct Entry {
+			QueuedEvent *	evt;
+			const void *	object;	//!< Coalesce object, NULL if not coalesced
+			int				type;	//!< Coalesce type
+		};
+		List<Entry>		events;		//!< The events in order
+		HashIndex		keyHash;	//!< Coalesce key to index into events
+
+		const void *	queue;		//!< The queue this batch belongs to
+		int				depth;		//!< Nesting depth of Begin
+		EventBatch *	nextOpen;	//!< The next open batch of this thread
 	};
 
 	// ==============================================================================
 	//! An event queue
+	//!
+	//! The backing queue can be LockFreeQueue, MpscQueue or SpscQueue, see the typedefs below.
+	//! Events get executed by one thread, in the order they have been added by each producer.
+	//!
+	//! Producers can collect events in a per thread batch, which gets added as a single event.
+	//!
+	//! @note	With a bounded queue, Add waits for the consumer while the queue is full,
+	//!			so the consumer thread must not add events itself.
 	// ==============================================================================
-	class EventQueue {
+	template<class QueueType>
+	class EventQueueEx {
 	public:
+		// ==============================================================================
+		//! Default constructor
+		// ==============================================================================
+		EventQueueEx() {}
+
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	size	The size of the backing queue
+		// ==============================================================================
+		explicit EventQueueEx( int size ) : queue(size) {}
+
 		// ==============================================================================
 		//! Destructor
 		// ==============================================================================
-		~EventQueue() {
+		~EventQueueEx() {
 			DeleteAll();
 		}
 
@@ -71,32 +177,92 @@ namespace og {
 		//! @param	evt	The event to add
 		// ==============================================================================
 		void Add( QueuedEvent *evt ) {
-			queue.Produce( evt );
+			while( !queue.Produce( evt ) )
+				Sleep( 0 );
+		}
+
+		// ==============================================================================
+		//! Create an event and add it to the queue
+		//!
+		//! Call like Add<MyEvent>( arg1, arg2 ), up to 4 arguments get passed to the constructor.
+		// ==============================================================================
+		template<class T>
+		void Add( void ) { Add( new T ); }
+		template<class T, class A1>
+		void Add( const A1 &a1 ) { Add( new T( a1 ) ); }
+		template<class T, class A1, class A2>
+		void Add( const A1 &a1, const A2 &a2 ) { Add( new T( a1, a2 ) ); }
+		template<class T, class A1, class A2, class A3>
+		void Add( const A1 &a1, const A2 &a2, const A3 &a3 ) { Add( new T( a1, a2, a3 ) ); }
+		template<class T, class A1, class A2, class A3, class A4>
+		void Add( const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4 ) { Add( new T( a1, a2, a3, a4 ) ); }
+
+		// ==============================================================================
+		//! Start collecting events added by this thread with AddBatched
+		//!
+		//! Calls can be nested, the batch gets published by the outermost FlushBatch.
+		// ==============================================================================
+		void BeginBatch( void ) {
+			EventBatch::Begin( this );
+		}
+
+		// ==============================================================================
+		//! End a batch started by BeginBatch and add the collected events as one event
+		//!
+		//! @return	true if a batch got added, so the consumer needs a wake up
+		// ==============================================================================
+		bool FlushBatch( void ) {
+			EventBatch *batch = EventBatch::End( this );
+			if ( batch == NULL )
+				return false;
+			Add( batch );
+			return true;
+		}
+
+		// ==============================================================================
+		//! Add an event to the batch of this thread, or to the queue if there is no batch
+		//!
+		//! @param	evt	The event to add
+		//!
+		//! @return	true if the event went to the queue directly, so the consumer needs a wake up
+		//! @see	QueuedEvent::GetCoalesceKey
+		// ==============================================================================
+		bool AddBatched( QueuedEvent *evt ) {
+			if ( EventBatch::Append( this, evt ) )
+				return false;
+			Add( evt );
+			return true;
 		}
 
 		// ==============================================================================
 		//! Process all events ( calls Execute on the event )
 		// ==============================================================================
 		void ProcessAll( void ) {
-			QueuedEvent *evt;
-			while( (evt=queue.Consume()) != NULL ) {
-				evt->Execute();
-				delete evt;
-			}
+			queue.ConsumeAll( ExecuteEvent );
 		}
 
 		// ==============================================================================
 		//! Delete all remaining events without calling Execute
 		// ==============================================================================
 		void DeleteAll( void ) {
-			QueuedEvent *evt;
-			while( (evt=queue.Consume()) != NULL )
-				delete evt;
+			queue.ConsumeAll( DeleteEvent );
 		}
 
 	private:
-		LockFreeQueue<QueuedEvent> queue;	//!< The queue
+		static void ExecuteEvent( QueuedEvent *evt ) {
+			evt->Execute();
+			delete evt;
+		}
+		static void DeleteEvent( QueuedEvent *evt ) {
+			delete evt;
+		}
+
+		QueueType queue;	//!< The queue
 	};
+
+	typedef EventQueueEx< LockFreeQueue<QueuedEvent> >	EventQueue;		//!< Any number of producers and consumers, unbounded
+	typedef EventQueueEx< MpscQueue<QueuedEvent> >		MpscEventQueue;	//!< Multiple producers, one consumer, bounded
+	typedef EventQueueEx< SpscQueue<QueuedEvent> >		SpscEventQueue;	//!< One producer, one consumer, bounded
 //! @}
 }
 
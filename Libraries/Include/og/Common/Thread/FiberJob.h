@@ -0,0 +1,241 @@
+// ==============================================================================
+//! @file
+//! @brief	Jobs running on fibers, which can wait for file reads without blocking a worker
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+
+#ifndef __OG_FIBER_JOB_H__
+#define __OG_FIBER_JOB_H__
+
+#include <og/Common/Thread/JobManager.h>
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Common Common (Library)
+//! @{
+	class AsyncFileReader;
+
+	// ==============================================================================
+	//! An execution context with its own stack, switched to cooperatively
+	//!
+	//! Uses Win32 fibers or ucontext. A fiber may be entered from a different thread
+	//! than the one it left, so don't keep pointers to thread local data across Leave().
+	// ==============================================================================
+	class Fiber {
+	public:
+		typedef void (*Func)( void *param );	//!< The fiber main function
+
+		// ==============================================================================
+		//! Constructor
+		// ==============================================================================
+		Fiber() : data(NULL) {}
+
+		// ==============================================================================
+		//! Destructor, the fiber must not be running
+		// ==============================================================================
+		~Fiber();
+
+		// ==============================================================================
+		//! Create the fiber, replaces a previous one
+		//!
+		//! @param	func		The function to run on the fiber
+		//! @param	param		The parameter to pass to func
+		//! @param	stackSize	The stack size in bytes
+		//!
+		//! @return	false if the fiber could not be created
+		// ==============================================================================
+		bool	Create( Func func, void *param, int stackSize );
+
+		// ==============================================================================
+		//! Find out if the fiber has been created and not finished yet
+		//!
+		//! @return	true if the fiber can be entered
+		// ==============================================================================
+		bool	IsActive( void ) const;
+
+		// ==============================================================================
+		//! Switch to the fiber, returns when the fiber calls Leave() or its function returns
+		// ==============================================================================
+		void	Enter( void );
+
+		// ==============================================================================
+		//! Switch back to where Enter() has been called ( from within the fiber only )
+		// ==============================================================================
+		void	Leave( void );
+
+	private:
+		void	*data;	//!< A pointer to the platform specific fiber data
+
+		Fiber( const Fiber & );
+		Fiber &operator=( const Fiber & );
+	};
+
+	// ==============================================================================
+	//! A job running on its own fiber
+	//!
+	//! Instead of blocking the worker, Run() can suspend the job until something calls Resume(),
+	//! like LoadFile does. Meanwhile the worker takes other jobs, and the job continues on any
+	//! worker, so a few workers can keep many loads in flight.
+	//!
+	//! @note	A suspended job still counts as pending for JobManager::WaitForDone
+	//! @note	Each job has its own stack, keep it small for jobs that get added in large numbers
+	//! @note	Can't be used as a JobGraph node
+	// ==============================================================================
+	class FiberJob : public Job {
+	public:
+		static const int DEFAULT_STACK_SIZE = 128 * 1024;	//!< The default stack size in bytes
+
+		// ==============================================================================
+		//! Runs the fiber until Run() returns or the job gets suspended
+		//!
+		//! @return	The result of Run(), or JOB_SUSPEND
+		// ==============================================================================
+		JobResult	Execute( void );
+
+		// ==============================================================================
+		//! Continue the job after Suspend(), from any thread
+		//!
+		//! If the job has not suspended yet, the next Suspend() returns right away.
+		// ==============================================================================
+		void		Resume( void );
+
+	protected:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	manager		The job manager this job gets added to
+		//! @param	stackSize	The stack size of the fiber in bytes
+		// ==============================================================================
+		FiberJob( JobManager *manager, int stackSize=DEFAULT_STACK_SIZE );
+
+		// ==============================================================================
+		//! The work to do, runs on the fiber
+		//!
+		//! @return	JobResult: What to do next, JOB_REPEAT starts Run() over
+		// ==============================================================================
+		virtual JobResult	Run( void ) = 0;
+
+		// ==============================================================================
+		//! Give the worker back until Resume() gets called ( from within Run() only )
+		// ==============================================================================
+		void		Suspend( void );
+
+		// ==============================================================================
+		//! Give the worker back and continue as soon as a worker is free ( from within Run() only )
+		// ==============================================================================
+		void		Reschedule( void );
+
+		// ==============================================================================
+		//! Load a file on the reader thread, the job is suspended until it's done ( from within Run() only )
+		//!
+		//! @param	reader	The file reader
+		//! @param	path	The file to load
+		//! @param	buffer	Where to store the pointer to the data, free it with FileSystemCore::FreeFile
+		//!
+		//! @return	The file size, -1 on failure or if the reader is not running
+		// ==============================================================================
+		int			LoadFile( AsyncFileReader *reader, const char *path, byte **buffer );
+
+	private:
+		// ==============================================================================
+		//! The fiber main function
+		//!
+		//! @param	param	The job
+		// ==============================================================================
+		static void	FiberMain( void *param );
+
+		JobManager *manager;	//!< The job manager
+		Fiber		fiber;		//!< The fiber running Run()
+		int			stackSize;	//!< The fiber stack size
+		AtomicInt	state;		//!< FIBER_RUNNING, FIBER_SUSPENDING, FIBER_SUSPENDED or FIBER_RESUMED
+		JobResult	result;		//!< The result of Run()
+	};
+
+	// ==============================================================================
+	//! A file read requested by FiberJob::LoadFile
+	// ==============================================================================
+	class FileReadRequest {
+	public:
+		FiberJob *		job;	//!< The job to resume when done
+		const char *	path;	//!< The file to load
+		byte **			buffer;	//!< Where to store the data
+		int				size;	//!< The result of FileSystemCore::LoadFile
+	};
+
+	// ==============================================================================
+	//! A thread loading files for fiber jobs
+	//!
+	//! @see	FiberJob::LoadFile
+	// ==============================================================================
+	class AsyncFileReader {
+	public:
+		// ==============================================================================
+		//! Constructor
+		// ==============================================================================
+		AsyncFileReader();
+
+		// ==============================================================================
+		//! Destructor, stops the thread
+		// ==============================================================================
+		~AsyncFileReader();
+
+		// ==============================================================================
+		//! Start the reader thread
+		//!
+		//! @param	fileSystem	The file system to load from
+		// ==============================================================================
+		void	Start( FileSystemCore *fileSystem );
+
+		// ==============================================================================
+		//! Stop the reader thread, the reads still queued get done first
+		//!
+		//! @note	Stop the reader before the job manager, so the waiting jobs can be continued
+		// ==============================================================================
+		void	Stop( void );
+
+		// ==============================================================================
+		//! Queue a read
+		//!
+		//! @param	request	The request, must stay valid until the job gets resumed
+		//!
+		//! @return	false if the reader is not running
+		// ==============================================================================
+		bool	Read( FileReadRequest *request );
+
+	private:
+		friend class AsyncFileReaderThread;
+
+		ogst::mutex					mutex;		//!< Protects thread
+		Thread *					thread;		//!< The reader thread, NULL when not running
+		FileSystemCore *			fileSystem;	//!< The file system to load from
+		LockFreeQueue<FileReadRequest>	requests;	//!< The queued reads
+	};
+
+//! @}
+}
+
+#endif
@@ -0,0 +1,187 @@
+// ==============================================================================
+//! @file
+//! @brief	Job Graph ( jobs with dependencies )
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+#ifndef __OG_JOB_GRAPH_H__
+#define __OG_JOB_GRAPH_H__
+
+#include <og/Common/Thread/JobManager.h>
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Common Common (Library)
+//! @{
+	class JobGraph;
+
+	// ==============================================================================
+	//! A node of a job graph, wraps the user job
+	//!
+	//! @note	Created by JobGraph::AddJob, owned by the graph
+	// ==============================================================================
+	class JobNode : public Job {
+	public:
+		// ==============================================================================
+		//! Get the wrapped job
+		//!
+		//! @return	The job, NULL if it returned JOB_DELETE
+		// ==============================================================================
+		Job *		GetJob( void ) const { return job; }
+
+		// ==============================================================================
+		//! Executes the wrapped job and releases the continuations
+		//!
+		//! @return	JOB_DONE, the node belongs to the graph
+		// ==============================================================================
+		JobResult	Execute( void );
+
+		// ==============================================================================
+		//! Cancels the wrapped job and all continuations
+		//!
+		//! @return	JOB_DONE, the node belongs to the graph
+		// ==============================================================================
+		JobResult	Cancel( void );
+
+		// ==============================================================================
+		//! Forwards the missed deadline to the wrapped job
+		//!
+		//! @param	usecLate	How many microseconds the deadline has been missed by
+		// ==============================================================================
+		void		DeadlineMissed( uLongLong usecLate );
+
+	private:
+		friend class JobGraph;
+
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	_graph	The graph
+		//! @param	_job	The job to wrap
+		// ==============================================================================
+		JobNode( JobGraph *_graph, Job *_job ) : graph(_graph), job(_job), numDependencies(0), dependencyCanceled(false) {}
+
+		// ==============================================================================
+		//! Release the continuations, runs or cancels those that have no more pending dependencies
+		//!
+		//! @param	canceled	true if this node got canceled
+		// ==============================================================================
+		void		ReleaseContinuations( bool canceled );
+
+		JobGraph *		graph;				//!< The graph
+		Job *			job;				//!< The wrapped job
+		int				numDependencies;	//!< Number of nodes that need to finish first
+		AtomicInt		numPending;			//!< Number of dependencies not finished yet
+		List<JobNode *>	continuations;		//!< Nodes that depend on this one
+		bool			dependencyCanceled;	//!< A dependency got canceled, so this one will be too
+	};
+
+	// ==============================================================================
+	//! A set of jobs with dependencies, run by a JobManager
+	//!
+	//! Jobs start as soon as all their dependencies are done.
+	//! Each graph has its own wait handle, so waiting for one graph does not stall the manager,
+	//! and multiple graphs can be in flight at the same time.
+	//! A graph can be submitted again once it is done, so per-frame pipelines only need to be set up once.
+	//! Nodes take over the priority and deadline of their job on each submit.
+	//!
+	//! @note	Jobs must return JOB_DONE or JOB_DELETE, JOB_REPEAT and JOB_SUSPEND ( FiberJob ) are not allowed
+	//! @note	Jobs returning JOB_DELETE are deleted, their nodes won't run anything when submitted again
+	// ==============================================================================
+	class JobGraph {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	mgr		The job manager to run the jobs on
+		// ==============================================================================
+		JobGraph( JobManager *mgr );
+
+		// ==============================================================================
+		//! Destructor, waits for the graph to be done
+		// ==============================================================================
+		~JobGraph();
+
+		// ==============================================================================
+		//! Add a job
+		//!
+		//! @param	job		The job to add, its Execute must return JOB_DONE or JOB_DELETE
+		//!
+		//! @return	The node to use for adding dependencies
+		// ==============================================================================
+		JobNode *	AddJob( Job *job );
+
+		// ==============================================================================
+		//! Make a node wait for another node to be done
+		//!
+		//! @param	first	The node that needs to be done first
+		//! @param	then	The node to run after first
+		// ==============================================================================
+		void		AddDependency( JobNode *first, JobNode *then );
+
+		// ==============================================================================
+		//! Remove all nodes ( does not delete the wrapped jobs )
+		// ==============================================================================
+		void		Clear( void );
+
+		// ==============================================================================
+		//! Start running the graph
+		//!
+		//! @note	Nodes without dependencies get added to the job manager right away
+		// ==============================================================================
+		void		Submit( void );
+
+		// ==============================================================================
+		//! Wait for all nodes of this graph to be done
+		// ==============================================================================
+		void		Wait( void );
+
+		// ==============================================================================
+		//! Find out if all nodes of this graph are done
+		//!
+		//! @return	true if done ( or never submitted ), false if not
+		// ==============================================================================
+		bool		IsDone( void ) const { return numRemaining.Get() == 0; }
+
+	private:
+		friend class JobNode;
+
+		// ==============================================================================
+		//! A node finished or got canceled
+		// ==============================================================================
+		void		NodeDone( void );
+
+		JobManager *	manager;		//!< The job manager
+		List<JobNode *>	nodes;			//!< All nodes
+		AtomicInt		numRemaining;	//!< Number of nodes not done yet
+		bool			isDone;			//!< Set when numRemaining reached 0, protected by doneWaiter
+		Condition		doneWaiter;		//!< The done waiter condition
+	};
+
+//! @}
+}
+
+#endif
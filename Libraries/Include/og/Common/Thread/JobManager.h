@@ -32,6 +32,8 @@
 
 #include <og/Common.h>
 #include <og/Common/Thread/LockFreeQueue.h>
+#include <og/Common/Thread/ObjectPool.h>
+#include <og/Common/Thread/WorkStealingQueue.h>
 
 //! Open Game Libraries
 namespace og {
@@ -45,14 +47,29 @@ namespace og {
 	enum JobResult {
 		JOB_DONE,	//!< Nothing happens ( user manually cleans the job )
 		JOB_REPEAT,	//!< Job gets re-added to the end of the job-queue
-		JOB_DELETE	//!< The job object will be deleted
+		JOB_DELETE,	//!< The job object will be deleted
+		JOB_SUSPEND	//!< The job waits for something and gets continued by JobManager::ResumeJob, it still counts as pending
+	};
+
+	// ==============================================================================
+	//! Priority class of a job, each class has its own queue
+	// ==============================================================================
+	enum JobPriority {
+		JOB_PRIORITY_CRITICAL,		//!< Taken before anything else ( frame critical work )
+		JOB_PRIORITY_NORMAL,		//!< The default
+		JOB_PRIORITY_BACKGROUND,	//!< Only when nothing else is waiting, not on all workers while other jobs are pending
+		JOB_PRIORITY_COUNT
 	};
 
 	// ==============================================================================
 	//! A job to execute
+	//!
+	//! @note	Jobs are allocated from the ObjectPool
 	// ==============================================================================
 	class Job {
 	public:
+		OG_POOLED_OBJECT
+
 		// ==============================================================================
 		//! Virtual destructor
 		// ==============================================================================
@@ -73,6 +90,75 @@ namespace og {
 		//! @return	JobResult: Default is JOB_DELETE, all others won't do anything
 		// ==============================================================================
 		virtual JobResult	Cancel( void ) { return JOB_DELETE; }
+
+		// ==============================================================================
+		//! Called right before Execute, when the job starts after its deadline
+		//!
+		//! Can be used to report the miss or to do a cheaper version of the work.
+		//!
+		//! @param	usecLate	How many microseconds the deadline has been missed by
+		// ==============================================================================
+		virtual void		DeadlineMissed( uLongLong /*usecLate*/ ) {}
+
+		// ==============================================================================
+		//! Set the priority class, takes effect the next time the job gets added
+		//!
+		//! @param	_priority	The priority class, JOB_PRIORITY_NORMAL by default
+		// ==============================================================================
+		void				SetPriority( JobPriority _priority ) { priority = _priority; }
+
+		// ==============================================================================
+		//! Get the priority class
+		//!
+		//! @return	The priority class
+		// ==============================================================================
+		JobPriority			GetPriority( void ) const { return priority; }
+
+		// ==============================================================================
+		//! Set the latest time the job should start at
+		//!
+		//! @param	time	Absolute time in microseconds ( see SysInfo::GetHiResTime ), 0 for none
+		// ==============================================================================
+		void				SetDeadline( uLongLong time ) { deadline = time; }
+
+		// ==============================================================================
+		//! Get the deadline
+		//!
+		//! @return	The deadline in microseconds, 0 for none
+		// ==============================================================================
+		uLongLong			GetDeadline( void ) const { return deadline; }
+
+	protected:
+		// ==============================================================================
+		//! Constructor
+		// ==============================================================================
+		Job() : priority(JOB_PRIORITY_NORMAL), deadline(0) {}
+
+	private:
+		JobPriority	priority;	//!< The priority class
+		uLongLong	deadline;	//!< The latest start time in microseconds, 0 for none
+	};
+
+	// ==============================================================================
+	//! The local queue and parking spot of a worker
+	//!
+	//! @note	Slots live as long as the JobManager, so other threads can always access them,
+	//!			even while the worker that used it is being stopped.
+	// ==============================================================================
+	class WorkerSlot {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	_index	The index within the job manager
+		// ==============================================================================
+		WorkerSlot( int _index ) : index(_index) {}
+
+		int						index;	//!< The index within the job manager
+		WorkStealingQueue<Job>	queue;	//!< The local job queue
+		AtomicInt				inUse;	//!< 1 if a worker owns this slot
+		AtomicInt				idle;	//!< 1 while the owner is parked
+		Condition				wakeUp;	//!< Signaled to wake up the parked owner
 	};
 
 	// ==============================================================================
@@ -85,18 +171,35 @@ namespace og {
 		//!
 		//! @param	_manager	The manager of this worker
 		// ==============================================================================
-		WorkerThread( JobManager *_manager ) : job(NULL), manager(_manager) {}
+		WorkerThread( JobManager *_manager ) : manager(_manager), slot(NULL), randomSeed(0), numTaken(0), inBackground(false) {}
 
 		// ==============================================================================
-		//! Set the new job
-		//!
-		//! @param	_job	The job
+		//! Wake up from hibernation, also wakes up a worker parked in its slot
 		// ==============================================================================
-		void SetJob( Job *_job ) { job = _job; }
+		void WakeUp( void );
 
 	private:
-		Job *		job;		//!< The job
+		friend class JobManager;
+
 		JobManager *manager;	//!< The manager
+		WorkerSlot *slot;		//!< The local queue and parking spot
+		uInt		randomSeed;	//!< Seed for picking a random victim to steal from
+		uInt		numTaken;	//!< Number of jobs taken, for the background share
+		bool		inBackground;	//!< The current job came from the background queue
+
+		// ==============================================================================
+		//! Park this worker in its slot until new jobs arrive
+		//!
+		//! @return	A job that was found while parking, or NULL after waking up
+		// ==============================================================================
+		Job *Park( void );
+
+		// ==============================================================================
+		//! Get a pseudo random number
+		//!
+		//! @return	The next random number
+		// ==============================================================================
+		uInt NextRandom( void );
 
 	protected:
 		// ==============================================================================
@@ -107,13 +210,27 @@ namespace og {
 
 	// ==============================================================================
 	//! A job manager
+	//!
+	//! By default all jobs go through one shared queue and idle workers take them from there.
+	//! In work stealing mode every worker has its own queue: jobs added from within
+	//! Job::Execute go to the local queue of the executing worker, jobs from other threads
+	//! go to the shared queue, and idle workers steal from the other workers.
+	//! Job order is not guaranteed in work stealing mode.
+	//!
+	//! Critical jobs are always taken first and background jobs only when nothing else is waiting
+	//! ( see SetBackgroundShare ). Only normal jobs go to the local queues.
+	//! While critical or normal jobs are queued or running, at most all but one workers start
+	//! background jobs, so long running background work like preloading can't block frame work.
+	//! A pool with nothing but background jobs uses all of its workers for them.
 	// ==============================================================================
 	class JobManager {
 	public:
 		// ==============================================================================
-		//! Default constructor
+		//! Constructor
+		//!
+		//! @param	workStealing	true to use per-worker queues with work stealing
 		// ==============================================================================
-		JobManager() : numThreadsWanted(0), waitForDone(false) {}
+		JobManager( bool workStealing=false );
 
 		// ==============================================================================
 		//! Destructor, kills all remaining untouched jobs, waits for the ones in progress
@@ -127,6 +244,31 @@ namespace og {
 		// ==============================================================================
 		void	AddJob( Job *job );
 
+		// ==============================================================================
+		//! Create a job and add it to the queue
+		//!
+		//! Call like AddJob<MyJob>( arg1, arg2 ), up to 4 arguments get passed to the constructor.
+		// ==============================================================================
+		template<class T>
+		void	AddJob( void ) { AddJob( new T ); }
+		template<class T, class A1>
+		void	AddJob( const A1 &a1 ) { AddJob( new T( a1 ) ); }
+		template<class T, class A1, class A2>
+		void	AddJob( const A1 &a1, const A2 &a2 ) { AddJob( new T( a1, a2 ) ); }
+		template<class T, class A1, class A2, class A3>
+		void	AddJob( const A1 &a1, const A2 &a2, const A3 &a3 ) { AddJob( new T( a1, a2, a3 ) ); }
+		template<class T, class A1, class A2, class A3, class A4>
+		void	AddJob( const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4 ) { AddJob( new T( a1, a2, a3, a4 ) ); }
+
+		// ==============================================================================
+		//! Continue a job that returned JOB_SUSPEND, from any thread
+		//!
+		//! @param	job	The suspended job
+		//!
+		//! @note	Unlike AddJob, this is not canceled during WaitForDone, since the job still counts as pending
+		// ==============================================================================
+		void	ResumeJob( Job *job );
+
 		// ==============================================================================
 		//! Change the number workers
 		//!
@@ -135,8 +277,73 @@ namespace og {
 		// ==============================================================================
 		void	SetNumWorkers( int num, bool blocking=false );
 
+		// ==============================================================================
+		//! Get the number of workers
+		//!
+		//! @return	The number of wanted workers, might differ for a moment after SetNumWorkers
+		// ==============================================================================
+		int		GetNumWorkers( void ) const { return Max( numThreadsWanted.Get(), 0 ); }
+
+		// ==============================================================================
+		//! Set how idle workers wait for new jobs
+		//!
+		//! @param	policy	The wait policy, defaults to WaitPolicy::PowerSaving()
+		//!
+		//! @note	Spinning pays off for many short jobs, sleeping right away for a few long ones
+		// ==============================================================================
+		void	SetWaitPolicy( const WaitPolicy &policy ) { waitPolicy = policy; }
+
+		// ==============================================================================
+		//! Set which physical cores the workers get pinned to
+		//!
+		//! Workers get one physical core each ( see CpuTopology::GetSpreadCpu ), so they don't migrate
+		//! between cores or NUMA nodes. The cores before firstCore are left for the main, audio and
+		//! filesystem threads, which can be pinned with Thread::SetAffinity.
+		//!
+		//! @param	firstCore	The first physical core for the workers, -1 to not pin them.
+		//!						1 by default, so core 0 stays free for the main thread ( unless there is only one core )
+		//!
+		//! @note	Takes effect for workers started afterwards
+		// ==============================================================================
+		void	SetWorkerCores( int firstCore ) { firstWorkerCore = firstCore; }
+
+		// ==============================================================================
+		//! Run the workers with a lower os priority, so they yield to other threads
+		//!
+		//! Meant for pools that only do background work like loading, so the os
+		//! prefers the frame workers and the main thread whenever they have work.
+		//!
+		//! @param	low	true for a lower priority, false by default
+		//!
+		//! @note	Takes effect for workers started afterwards
+		// ==============================================================================
+		void	SetLowPriority( bool low ) { lowPriority = low; }
+
+		// ==============================================================================
+		//! Let background jobs have a share even while normal jobs are waiting
+		//!
+		//! @param	everyNth	Every n-th job a worker takes is looked for in the background queue first,
+		//!						0 for strict priorities ( default )
+		// ==============================================================================
+		void	SetBackgroundShare( int everyNth ) { backgroundShare = Max( everyNth, 0 ); }
+
+		// ==============================================================================
+		//! Get the number of jobs that started after their deadline
+		//!
+		//! @return	The number of missed deadlines since the last reset
+		// ==============================================================================
+		int		GetNumMissedDeadlines( void ) const { return numMissedDeadlines.Get(); }
+
+		// ==============================================================================
+		//! Reset the missed deadline counter, for example once per frame
+		// ==============================================================================
+		void	ResetNumMissedDeadlines( void ) { numMissedDeadlines.Set( 0 ); }
+
 		// ==============================================================================
 		//! Wait for all jobs to be done
+		//!
+		//! @note	Jobs added by other threads while waiting get canceled, repeating jobs won't repeat.
+		//!			Jobs added from within Job::Execute are still run.
 		// ==============================================================================
 		void	WaitForDone( void );
 
@@ -147,11 +354,15 @@ namespace og {
 
 	private:
 		friend class WorkerThread;
+		friend class FindJobCheck;
 
 		// ==============================================================================
-		//! Trigger the next job
+		//! Add a job to the queue
+		//!
+		//! @param	job			The job to add
+		//! @param	allowLocal	Allow pushing onto the local queue of the calling worker ( work stealing only )
 		// ==============================================================================
-		void	TriggerNextJob( bool wakeUp=true );
+		void	QueueJob( Job *job, bool allowLocal );
 
 		// ==============================================================================
 		//! A worker is done
@@ -161,54 +372,72 @@ namespace og {
 		void	WorkerIsDone( WorkerThread *worker );
 
 		// ==============================================================================
-		//! Add a free worker
+		//! Get the next job for a worker: critical queue, local queue, normal queue,
+		//! steal from others, then the background queue
+		//!
+		//! @param	worker	The worker
+		//!
+		//! @return	NULL if no job was found
+		// ==============================================================================
+		Job *	FindJob( WorkerThread *worker );
+
+		// ==============================================================================
+		//! Take a job from the background queue, if not too many workers run background jobs already
+		//!
+		//! @param	worker	The worker
 		//!
-		//! @param	worker	The worker. 
+		//! @return	NULL if no job was found
 		// ==============================================================================
-		void	AddFreeWorker( WorkerThread *worker, bool wakeUp=true );
+		Job *	FindBackgroundJob( WorkerThread *worker );
 
-		ogst::mutex					listMutex;			//!< Protects numThreadsWanted and allThreads
-		int							numThreadsWanted;	//!< The number of wanted threads wanted
+		// ==============================================================================
+		//! Wake up one parked worker, if any
+		// ==============================================================================
+		void	WakeIdleWorker( void );
+
+		// ==============================================================================
+		//! A job has been executed
+		// ==============================================================================
+		void	JobFinished( void );
+
+		// ==============================================================================
+		//! Assign a free slot to a worker, waits until one is free
+		//!
+		//! @param	worker	The worker
+		//!
+		//! @return	false if the worker was stopped before it got a slot
+		// ==============================================================================
+		bool	AcquireSlot( WorkerThread *worker );
+
+		// ==============================================================================
+		//! Release the slot of a worker
+		//!
+		//! @param	worker	The worker
+		// ==============================================================================
+		void	ReleaseSlot( WorkerThread *worker );
+
+		static const int MAX_WORKERS = 128;	//!< Maximum number of workers
+
+		ogst::mutex					listMutex;			//!< Protects changes to numThreadsWanted and allThreads
+		AtomicInt					numThreadsWanted;	//!< The number of wanted threads wanted
 		List<WorkerThread *>		allThreads;			//!< A list of all worker threads
+		AtomicInt					numThreads;			//!< allThreads.Num(), readable without locking
 		bool						waitForDone;		//!< Waiting to be done ( see WaitForDone )
 		Condition					doneWaiter;			//!< The done waiter condition
-		LockFreeQueue<WorkerThread>	availableThreads;	//!< The available (job-less) threads
-		LockFreeQueue<Job>			jobList;			//!< The list of jobs to do
-
-		// ==============================================================================
-		//! The job that ends the WaitForDone()
-		// ==============================================================================
-		class JobStopWaitDone : public Job {
-		public:
-			// ==============================================================================
-			//! Constructor
-			//!
-			//! @param	mgr	The manager
-			// ==============================================================================
-			JobStopWaitDone( JobManager *mgr ) : manager(mgr) {}
-
-			// ==============================================================================
-			//! Stop waiting for done and signal the waiter
-			//!
-			//! @return	JOB_DELETE
-			// ==============================================================================
-			JobResult	Execute( void ) {
-				manager->waitForDone = false;
-				manager->doneWaiter.Signal();
-				return JOB_DELETE;
-			}
-
-			// ==============================================================================
-			//! Cancel should never be called on this one
-			// ==============================================================================
-			JobResult	Cancel( void ) {
-				OG_ASSERT( false );
-				return JOB_DELETE;
-			}
-
-		private:
-			JobManager *manager;	//!< The manager
-		};
+		LockFreeQueue<Job>			jobLists[JOB_PRIORITY_COUNT];	//!< The shared job queues, one per priority class
+
+		bool						workStealing;		//!< Use per-worker queues with work stealing
+		AtomicInt					numPendingJobs;		//!< Added jobs that have not finished yet
+		AtomicInt					numSlots;			//!< Number of allocated slots
+		WorkerSlot *				slots[MAX_WORKERS];	//!< The worker slots, allocated by SetNumWorkers
+		LockFreeQueue<WorkerSlot>	parkedSlots;		//!< Slots with a parked worker, may contain stale entries
+		WaitPolicy					waitPolicy;			//!< How idle workers wait for new jobs
+		int							firstWorkerCore;	//!< The first physical core for the workers, -1 to not pin them
+		bool						lowPriority;		//!< Run the workers with a lower os priority
+		int							backgroundShare;	//!< Every n-th job prefers the background queue, 0 for never
+		AtomicInt					numInBackground;	//!< Workers currently running a background job
+		AtomicInt					numForeground;		//!< Critical and normal jobs queued or running
+		AtomicInt					numMissedDeadlines;	//!< Jobs that started after their deadline
 	};
 
 //! @}
@@ -91,7 +91,25 @@ namespace og {
 			}
 			return NULL;
 		}
-		
+
+		// ==============================================================================
+		//! Remove all entries from the queue
+		//!
+		//! @param	func	Function or functor to call for each entry: func( type *data )
+		//!
+		//! @return	The number of entries consumed
+		// ==============================================================================
+		template<class Func>
+		int ConsumeAll( Func func ) {
+			int num = 0;
+			void *p;
+			while( queue.Consume(&p) ) {
+				func( (type *)p );
+				num++;
+			}
+			return num;
+		}
+
 	private:
 		LockFreeQueueVoid queue;	//!< The queue
 	};
@@ -0,0 +1,88 @@
+// ==============================================================================
+//! @file
+//! @brief	Thread aware pool for small objects
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+#ifndef __OG_OBJECT_POOL_H__
+#define __OG_OBJECT_POOL_H__
+
+#include <og/Setup.h>
+#include <cstddef>
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Common Common (Library)
+//! @{
+
+	// ==============================================================================
+	//! Thread aware pool for small objects
+	//!
+	//! Blocks are sorted into size classes. Each thread keeps a small cache of free blocks
+	//! per size class, which get exchanged with a shared pool in batches.
+	//! So most allocations and frees don't lock, even if objects get created on one thread
+	//! and deleted on another one.
+	//!
+	//! @note	Pooled memory is kept for reuse until the program ends
+	//! @note	Use together with og::Thread, the caches get flushed when the thread ends
+	// ==============================================================================
+	class ObjectPool {
+	public:
+		static const size_t GRANULARITY	= 16;	//!< Size classes are multiples of this
+		static const size_t MAX_SIZE	= 256;	//!< Bigger allocations go to the global heap
+
+		// ==============================================================================
+		//! Allocate a block
+		//!
+		//! @param	size	The size in bytes
+		//!
+		//! @return	Pointer to the block
+		// ==============================================================================
+		static void *	Alloc( size_t size );
+
+		// ==============================================================================
+		//! Return a block to the pool
+		//!
+		//! @param	ptr		Pointer to the block, may be NULL
+		//! @param	size	The size passed to Alloc
+		// ==============================================================================
+		static void		Free( void *ptr, size_t size );
+	};
+
+// ==============================================================================
+//! Declare class operators new and delete that use the ObjectPool
+//!
+//! The class needs a virtual destructor if objects are deleted by a base class pointer,
+//! so delete gets the size of the actual object.
+// ==============================================================================
+#define OG_POOLED_OBJECT \
+	static void *operator new( size_t size ) { return og::ObjectPool::Alloc( size ); } \
+	static void operator delete( void *ptr, size_t size ) { og::ObjectPool::Free( ptr, size ); }
+
+//! @}
+}
+
+#endif
@@ -0,0 +1,206 @@
+// ==============================================================================
+//! @file
+//! @brief	Parallel For / Reduce
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+#ifndef __OG_PARALLEL_FOR_H__
+#define __OG_PARALLEL_FOR_H__
+
+#include <og/Common/Thread/JobManager.h>
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Common Common (Library)
+//! @{
+
+	// ==============================================================================
+	//! A range split into chunks, executed by the calling thread and helper jobs
+	//!
+	//! Helpers claim chunks until none are left, the calling thread does the same and
+	//! then waits for the chunks still in progress. Helpers that start late find nothing to do.
+	//!
+	//! @note	Internal, use ParallelFor or ParallelReduce
+	// ==============================================================================
+	class ParallelTask {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	manager	The job manager, decides the grain size if grain is <= 0
+		//! @param	begin	The first index
+		//! @param	end		One past the last index
+		//! @param	grain	The number of indices per chunk, <= 0 to choose one by the number of workers
+		// ==============================================================================
+		ParallelTask( JobManager *manager, int begin, int end, int grain );
+
+		// ==============================================================================
+		//! Virtual destructor
+		// ==============================================================================
+		virtual ~ParallelTask() {}
+
+		// ==============================================================================
+		//! Run all chunks, returns when all of them are done
+		// ==============================================================================
+		void		Run( void );
+
+		// ==============================================================================
+		//! Release a reference, deletes the task when it was the last one
+		// ==============================================================================
+		void		Release( void );
+
+		// ==============================================================================
+		//! Get the number of chunks
+		//!
+		//! @return	The number of chunks
+		// ==============================================================================
+		int			GetNumChunks( void ) const { return numChunks; }
+
+	protected:
+		// ==============================================================================
+		//! Execute one chunk
+		//!
+		//! @param	chunk	The chunk index
+		//! @param	from	The first index
+		//! @param	to		One past the last index
+		// ==============================================================================
+		virtual void	RunChunk( int chunk, int from, int to ) = 0;
+
+	private:
+		friend class ParallelTaskJob;
+
+		// ==============================================================================
+		//! Claim and execute chunks until none are left
+		// ==============================================================================
+		void		RunChunks( void );
+
+		JobManager *	manager;		//!< The job manager
+		int				begin;			//!< The first index
+		int				end;			//!< One past the last index
+		int				grain;			//!< The number of indices per chunk
+		int				numChunks;		//!< The number of chunks
+		AtomicInt		nextChunk;		//!< The next chunk to claim
+		AtomicInt		numDone;		//!< The number of finished chunks
+		AtomicInt		refCount;		//!< The caller and all helper jobs
+		bool			isDone;			//!< Set when all chunks are done, protected by doneWaiter
+		Condition		doneWaiter;		//!< The done waiter condition
+	};
+
+	// ==============================================================================
+	//! ParallelFor task
+	// ==============================================================================
+	template<class Func>
+	class ParallelForTask : public ParallelTask {
+	public:
+		ParallelForTask( JobManager *manager, int begin, int end, int grain, const Func &fn )
+			: ParallelTask( manager, begin, end, grain ), func(fn) {}
+
+	protected:
+		void	RunChunk( int chunk, int from, int to ) { func( from, to ); }
+
+	private:
+		const Func &func;
+	};
+
+	// ==============================================================================
+	//! ParallelReduce task
+	// ==============================================================================
+	template<class T, class Func>
+	class ParallelReduceTask : public ParallelTask {
+	public:
+		ParallelReduceTask( JobManager *manager, int begin, int end, int grain, const Func &fn )
+			: ParallelTask( manager, begin, end, grain ), func(fn) {
+			results = new T[GetNumChunks()];
+		}
+		~ParallelReduceTask() { delete[] results; }
+
+		const T &	GetResult( int chunk ) const { return results[chunk]; }
+
+	protected:
+		void	RunChunk( int chunk, int from, int to ) { results[chunk] = func( from, to ); }
+
+	private:
+		const Func &func;
+		T *			results;
+	};
+
+	// ==============================================================================
+	//! Run a loop in parallel
+	//!
+	//! The range gets split into chunks, which are executed by the workers and the calling thread.
+	//! fn gets called as fn( from, to ) for each chunk and must be safe to call from multiple threads.
+	//! Can be called from within a job.
+	//!
+	//! @param	manager	The job manager, NULL or no workers to run everything on the calling thread
+	//! @param	begin	The first index
+	//! @param	end		One past the last index
+	//! @param	grain	The minimum number of indices per chunk, <= 0 to choose one by the number of workers
+	//! @param	fn		The function or functor to call for each chunk: void fn( int from, int to )
+	// ==============================================================================
+	template<class Func>
+	void ParallelFor( JobManager *manager, int begin, int end, int grain, const Func &fn ) {
+		if ( begin >= end )
+			return;
+		ParallelForTask<Func> *task = new ParallelForTask<Func>( manager, begin, end, grain, fn );
+		task->Run();
+		task->Release();
+	}
+
+	// ==============================================================================
+	//! Reduce a range in parallel
+	//!
+	//! Like ParallelFor, but each chunk returns a partial result.
+	//! The partial results get joined in chunk order on the calling thread,
+	//! so the result does not depend on the scheduling.
+	//!
+	//! @param	manager		The job manager, NULL or no workers to run everything on the calling thread
+	//! @param	begin		The first index
+	//! @param	end			One past the last index
+	//! @param	grain		The minimum number of indices per chunk, <= 0 to choose one by the number of workers
+	//! @param	identity	The result for an empty range
+	//! @param	fn			The function or functor to call for each chunk: T fn( int from, int to )
+	//! @param	join		The function or functor to join two results: T join( const T &a, const T &b )
+	//!
+	//! @return	The joined result
+	// ==============================================================================
+	template<class T, class Func, class Join>
+	T ParallelReduce( JobManager *manager, int begin, int end, int grain, const T &identity, const Func &fn, const Join &join ) {
+		if ( begin >= end )
+			return identity;
+		ParallelReduceTask<T, Func> *task = new ParallelReduceTask<T, Func>( manager, begin, end, grain, fn );
+		task->Run();
+		T result = identity;
+		int num = task->GetNumChunks();
+		for( int i=0; i<num; i++ )
+			result = join( result, task->GetResult(i) );
+		task->Release();
+		return result;
+	}
+
+//! @}
+}
+
+#endif
@@ -45,7 +45,7 @@ namespace og {
 		// ==============================================================================
 		//! Default constructor
 		// ==============================================================================
-		PreloadTask() : isLoaded(false) {}
+		PreloadTask() : isLoaded(false), sequence(0), addTime(0), startTime(0), endTime(0) {}
 
 		// ==============================================================================
 		//! Virtual destructor
@@ -66,15 +66,55 @@ namespace og {
 		// ==============================================================================
 		virtual void	Synchronize( void ) = 0;
 
+		// ==============================================================================
+		//! Get a name for the timing records, like the file name of the asset
+		//!
+		//! @return	The name
+		// ==============================================================================
+		virtual const char *GetName( void ) const { return "unnamed"; }
+
+		// ==============================================================================
+		//! Get the time the task waited before Preload was called ( valid in Synchronize )
+		//!
+		//! @return	The time in microseconds
+		// ==============================================================================
+		uLongLong		GetWaitTime( void ) const { return startTime - addTime; }
+
+		// ==============================================================================
+		//! Get the time Preload took ( valid in Synchronize )
+		//!
+		//! @return	The time in microseconds
+		// ==============================================================================
+		uLongLong		GetPreloadTime( void ) const { return endTime - startTime; }
+
 	private:
 		friend class PreloadJob;
 		friend class PreloadManager;
 
-		bool	isLoaded;	//!< The return value of Preload()
+		bool		isLoaded;	//!< The return value of Preload()
+		int			sequence;	//!< The submission order
+		uLongLong	addTime;	//!< When the task was added
+		uLongLong	startTime;	//!< When Preload was called
+		uLongLong	endTime;	//!< When Preload returned
+	};
+
+	// ==============================================================================
+	//! Timing record of a synchronized preload task
+	// ==============================================================================
+	struct PreloadTiming {
+		String		name;			//!< The name of the task
+		uLongLong	waitTime;		//!< Microseconds from AddTask until Preload was called
+		uLongLong	preloadTime;	//!< Microseconds spent in Preload
+		uLongLong	syncTime;		//!< Microseconds spent in Synchronize
 	};
 
 	// ==============================================================================
 	//! Background data loading/generation, threaded
+	//!
+	//! Tasks wait in a pending list until there is room for their result, so no more than
+	//! the maximum number of tasks are preloaded or in progress before a Synchronize,
+	//! without any worker thread having to wait.
+	//! The worker threads run with a lower os priority, so preloading yields to frame work.
 	// ==============================================================================
 	class PreloadManager {
 	public:
@@ -83,12 +123,18 @@ namespace og {
 		// ==============================================================================
 		PreloadManager();
 
+		// ==============================================================================
+		//! Destructor, stops the worker threads and deletes all remaining tasks
+		// ==============================================================================
+		~PreloadManager();
+
 		// ==============================================================================
 		//! Start the background loader with one worker thread
 		//!
-		//! @param	num		The maximum number of preload tasks to be processed before the Synchronize
+		//! @param	num		The maximum number of preload tasks to be in progress or waiting for the Synchronize
+		//! @param	ordered	Synchronize the tasks in the order they were added, even if they finish in a different order
 		// ==============================================================================
-		void	Start( int num=16 );
+		void	Start( int num=16, bool ordered=false );
 
 		// ==============================================================================
 		//! Kill all remaining preload tasks, stop the worker threads and reset the progess
@@ -112,39 +158,98 @@ namespace og {
 		// ==============================================================================
 		//! Synchronize the processed preload tasks
 		//!
+		//! @param	usecBudget	Stop after this many microseconds, the rest gets synchronized on the next call.
+		//!						At least one task gets synchronized per call, 0 for no limit.
+		//!
 		//! @return	The current progress in percent
 		// ==============================================================================
-		float	Synchronize( void );
+		float	Synchronize( uLongLong usecBudget=0 );
 
 		// ==============================================================================
 		//! Get the current progress in percent
 		//!
 		//! @return	The current progress in percent
 		// ==============================================================================
-		float	GetProgress( void ) const { return progress; }
+		float	GetProgress( void ) const;
 
 		// ==============================================================================
 		//! Find out if all preload tasks have been processed
 		//!
 		//! @return	true if done, false if not
 		// ==============================================================================
-		bool	IsDone( void ) const { return numProcessed == numTotal; }
+		bool	IsDone( void ) const { return numProcessed.Get() == numTotal.Get(); }
 
 		// ==============================================================================
 		//! Reset the progress to 0%
 		// ==============================================================================
 		void	ResetProgress( void );
 
+		// ==============================================================================
+		//! Record a PreloadTiming for each synchronized task
+		//!
+		//! @param	enable	true to record, false to stop recording
+		// ==============================================================================
+		void	EnableTimings( bool enable ) { recordTimings = enable; }
+
+		// ==============================================================================
+		//! Get the recorded timings ( only call from the thread calling Synchronize )
+		//!
+		//! @return	The timings, in the order the tasks have been synchronized
+		// ==============================================================================
+		const List<PreloadTiming> &GetTimings( void ) const { return timings; }
+
+		// ==============================================================================
+		//! Clear the recorded timings
+		// ==============================================================================
+		void	ClearTimings( void ) { timings.Clear(); }
+
 	private:
 		friend class PreloadJob;
 
+		// ==============================================================================
+		//! Start pending tasks while there is room, the mutex must be locked
+		//!
+		//! @param	ready	Gets the tasks to start, add the jobs after unlocking the mutex
+		// ==============================================================================
+		void	TakeReadyTasks( List<PreloadTask *> &ready );
+
+		// ==============================================================================
+		//! Add a job for each task
+		//!
+		//! @param	ready	The tasks to start
+		// ==============================================================================
+		void	StartTasks( const List<PreloadTask *> &ready );
+
+		// ==============================================================================
+		//! A preload task has been processed ( called from the worker thread )
+		//!
+		//! @param	task	The task
+		// ==============================================================================
+		void	TaskPreloaded( PreloadTask *task );
+
+		// ==============================================================================
+		//! Get the next task to synchronize
+		//!
+		//! @return	NULL if there is none ( or the next one in order is not done yet )
+		// ==============================================================================
+		PreloadTask *NextPreloaded( void );
+
 		JobManager	manager;			//!< The manager
-		float		progress;			//!< The current progress
-		int			maxPreload;			//!< The maximum number of preload tasks to be processed before the Synchronize
-		Queue<PreloadTask *> preloaded;	//!< The preload tasks that have been processed
-		Condition	condition;			//!< The condition
-		int			numProcessed;		//!< Number of processed preload tasks
-		int			numTotal;			//!< Total number of preload tasks
+		int			maxPreload;			//!< The maximum number of preload tasks in progress or waiting for the Synchronize
+		int			numInFlight;		//!< Number of preload tasks in progress or waiting for the Synchronize
+		int			nextSequence;		//!< The sequence of the next added task
+		Queue<PreloadTask *> pending;	//!< The preload tasks waiting to be started
+		ogst::mutex	mutex;				//!< Protects pending, numInFlight and nextSequence
+		LockFreeQueue<PreloadTask> preloaded;	//!< The preload tasks that have been processed
+
+		bool		ordered;			//!< Synchronize in the order the tasks were added
+		int			nextSync;			//!< The sequence of the next task to synchronize in ordered mode
+		List<PreloadTask *> reorder;	//!< Processed tasks that have to wait for earlier ones in ordered mode
+
+		AtomicInt	numProcessed;		//!< Number of processed preload tasks
+		AtomicInt	numTotal;			//!< Total number of preload tasks
+		bool		recordTimings;		//!< Record a PreloadTiming for each task
+		List<PreloadTiming> timings;	//!< The recorded timings
 	};
 
 //! @}
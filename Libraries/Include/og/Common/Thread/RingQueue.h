@@ -0,0 +1,281 @@
+// ==============================================================================
+//! @file
+//! @brief	Bounded single consumer ring buffer queues
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+//! @note	MpscQueue is based on the "Bounded MPMC queue" by Dmitry Vyukov
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+#ifndef __OG_RING_QUEUE_H__
+#define __OG_RING_QUEUE_H__
+
+#include <og/Common/Thread/Atomic.h>
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Common Common (Library)
+//! @{
+
+	// ==============================================================================
+	//! Bounded queue for one producer thread and one consumer thread
+	//!
+	//! A power of two ring buffer, producer and consumer indices live on their own cache lines.
+	// ==============================================================================
+	template<typename type>
+	class SpscQueue {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	size	The maximum number of elements, will be rounded up to a power of two
+		// ==============================================================================
+		SpscQueue( int size=1024 ) : cachedTail(0), cachedHead(0) {
+			int capacity = 1;
+			while( capacity < size )
+				capacity <<= 1;
+			mask = capacity - 1;
+			buffer = new type *[capacity];
+		}
+
+		// ==============================================================================
+		//! Destructor
+		// ==============================================================================
+		~SpscQueue() {
+			delete[] buffer;
+		}
+
+		// ==============================================================================
+		//! Add an entry to the queue ( producer thread only )
+		//!
+		//! @param	data	A pointer to the object
+		//!
+		//! @return	false if the queue is full
+		// ==============================================================================
+		bool	Produce( type *data ) {
+			int t = tail.Get();
+			if ( Distance( cachedHead, t ) > mask ) {
+				cachedHead = head.Get();
+				if ( Distance( cachedHead, t ) > mask )
+					return false;
+			}
+			buffer[t & mask] = data;
+			tail.Set( Advance( t, 1 ) );
+			return true;
+		}
+
+		// ==============================================================================
+		//! Get the next entry in the queue and remove it from the queue ( consumer thread only )
+		//!
+		//! @return	NULL if the queue is empty, otherwise the next entry
+		// ==============================================================================
+		type *	Consume( void ) {
+			int h = head.Get();
+			if ( h == cachedTail ) {
+				cachedTail = tail.Get();
+				if ( h == cachedTail )
+					return NULL;
+			}
+			type *data = buffer[h & mask];
+			head.Set( Advance( h, 1 ) );
+			return data;
+		}
+
+		// ==============================================================================
+		//! Remove all entries currently in the queue ( consumer thread only )
+		//!
+		//! The slots are handed back to the producer once, after the whole batch.
+		//!
+		//! @param	func	Function or functor to call for each entry: func( type *data )
+		//!
+		//! @return	The number of entries consumed
+		// ==============================================================================
+		template<class Func>
+		int		ConsumeAll( Func func ) {
+			int h = head.Get();
+			cachedTail = tail.Get();
+			int num = Distance( h, cachedTail );
+			for( int i=0; i<num; i++ )
+				func( buffer[Advance( h, i ) & mask] );
+			head.Set( Advance( h, num ) );
+			return num;
+		}
+
+	private:
+		// ==============================================================================
+		//! Get the distance between two indices, safe for overflowing indices
+		// ==============================================================================
+		static int Distance( int from, int to ) {
+			return static_cast<int>( static_cast<uInt>(to) - static_cast<uInt>(from) );
+		}
+
+		// ==============================================================================
+		//! Advance an index, safe for overflowing indices
+		// ==============================================================================
+		static int Advance( int index, int amount ) {
+			return static_cast<int>( static_cast<uInt>(index) + static_cast<uInt>(amount) );
+		}
+
+		AtomicInt	head;		//!< The next entry to consume
+		int			cachedTail;	//!< The consumers copy of tail
+		char		padHead[OG_CACHE_LINE_SIZE - sizeof(AtomicInt) - sizeof(int)];
+		AtomicInt	tail;		//!< The next free slot
+		int			cachedHead;	//!< The producers copy of head
+		char		padTail[OG_CACHE_LINE_SIZE - sizeof(AtomicInt) - sizeof(int)];
+		type **		buffer;		//!< The ring buffer
+		int			mask;		//!< Capacity - 1
+	};
+
+	// ==============================================================================
+	//! Bounded queue for multiple producer threads and one consumer thread
+	//!
+	//! A power of two ring buffer, each slot has a sequence number telling whether
+	//! it's ready to be written or read, so producers only compete for the tail index.
+	// ==============================================================================
+	template<typename type>
+	class MpscQueue {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	size	The maximum number of elements, will be rounded up to a power of two
+		// ==============================================================================
+		MpscQueue( int size=1024 ) : head(0) {
+			int capacity = 1;
+			while( capacity < size )
+				capacity <<= 1;
+			mask = capacity - 1;
+			buffer = new Cell[capacity];
+			for( int i=0; i<capacity; i++ )
+				buffer[i].sequence.Set( i );
+		}
+
+		// ==============================================================================
+		//! Destructor
+		// ==============================================================================
+		~MpscQueue() {
+			delete[] buffer;
+		}
+
+		// ==============================================================================
+		//! Add an entry to the queue ( any thread )
+		//!
+		//! @param	data	A pointer to the object
+		//!
+		//! @return	false if the queue is full
+		// ==============================================================================
+		bool	Produce( type *data ) {
+			Cell *cell;
+			int t = tail.Get();
+			for(;;) {
+				cell = &buffer[t & mask];
+				int diff = Distance( t, cell->sequence.Get() );
+				if ( diff == 0 ) {
+					int prev = tail.CompareExchange( Advance( t, 1 ), t );
+					if ( prev == t )
+						break;
+					t = prev;
+				} else if ( diff < 0 )
+					return false;
+				else
+					t = tail.Get();
+			}
+			cell->data = data;
+			cell->sequence.Set( Advance( t, 1 ) );
+			return true;
+		}
+
+		// ==============================================================================
+		//! Get the next entry in the queue and remove it from the queue ( consumer thread only )
+		//!
+		//! @return	NULL if the queue is empty, otherwise the next entry
+		// ==============================================================================
+		type *	Consume( void ) {
+			Cell *cell = &buffer[head & mask];
+			if ( cell->sequence.Get() != Advance( head, 1 ) )
+				return NULL;
+			type *data = cell->data;
+			cell->sequence.Set( Advance( head, mask + 1 ) );
+			head = Advance( head, 1 );
+			return data;
+		}
+
+		// ==============================================================================
+		//! Remove all entries that are ready ( consumer thread only )
+		//!
+		//! @param	func	Function or functor to call for each entry: func( type *data )
+		//!
+		//! @return	The number of entries consumed
+		// ==============================================================================
+		template<class Func>
+		int		ConsumeAll( Func func ) {
+			int num = 0;
+			Cell *cell;
+			type *data;
+			for(;;) {
+				cell = &buffer[head & mask];
+				if ( cell->sequence.Get() != Advance( head, 1 ) )
+					return num;
+				data = cell->data;
+				cell->sequence.Set( Advance( head, mask + 1 ) );
+				head = Advance( head, 1 );
+				num++;
+				func( data );
+			}
+		}
+
+	private:
+		// ==============================================================================
+		//! A slot of the ring buffer
+		// ==============================================================================
+		struct Cell {
+			AtomicInt	sequence;	//!< Slot index when free, slot index + 1 when filled
+			type *		data;		//!< The entry
+		};
+
+		// ==============================================================================
+		//! Get the distance between two indices, safe for overflowing indices
+		// ==============================================================================
+		static int Distance( int from, int to ) {
+			return static_cast<int>( static_cast<uInt>(to) - static_cast<uInt>(from) );
+		}
+
+		// ==============================================================================
+		//! Advance an index, safe for overflowing indices
+		// ==============================================================================
+		static int Advance( int index, int amount ) {
+			return static_cast<int>( static_cast<uInt>(index) + static_cast<uInt>(amount) );
+		}
+
+		AtomicInt	tail;		//!< The next free slot
+		char		padTail[OG_CACHE_LINE_SIZE - sizeof(AtomicInt)];
+		int			head;		//!< The next entry to consume, only used by the consumer
+		int			mask;		//!< Capacity - 1
+		Cell *		buffer;		//!< The ring buffer
+	};
+
+	//! @}
+}
+
+#endif
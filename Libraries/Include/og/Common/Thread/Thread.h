@@ -31,6 +31,7 @@
 #define __OG_THREAD_H__
 
 #include <og/Shared.h>
+#include <og/Common/Thread/Atomic.h>
 #if OG_HAVE_STD_THREAD
 	#include <thread>
 	#include <condition_variable>
@@ -61,6 +62,62 @@ namespace og {
 						//!  but can not be used by multiple threads at the same time without extra code.
 	};
 
+	// ==============================================================================
+	//! How a thread waits for work: spin, then yield, then go to sleep
+	//!
+	//! Spinning and yielding avoid the cost of going to sleep and being woken up again
+	//! when new work arrives shortly, but waste cpu time otherwise.
+	// ==============================================================================
+	class WaitPolicy {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	spins	Number of times to check for work with a cpu pause in between
+		//! @param	yields	Number of times to check for work after giving up the time slice
+		// ==============================================================================
+		WaitPolicy( int spins=0, int yields=0 ) : spinCount(spins), yieldCount(yields) {}
+
+		// ==============================================================================
+		//! Go to sleep right away, good for threads that are mostly idle
+		// ==============================================================================
+		static WaitPolicy	PowerSaving( void ) { return WaitPolicy( 0, 0 ); }
+
+		// ==============================================================================
+		//! Spin and yield for a while, good for threads that get short bursts of work
+		//!
+		//! @note	Only yields once on single core systems, spinning would just block the thread we wait for
+		// ==============================================================================
+		static WaitPolicy	LowLatency( void ) {
+			return ogst::thread::hardware_concurrency() > 1 ? WaitPolicy( 2000, 10 ) : WaitPolicy( 0, 1 );
+		}
+
+		// ==============================================================================
+		//! Check for work according to the policy, before going to sleep
+		//!
+		//! @param	check	Functor returning true when work is available: bool check()
+		//!
+		//! @return	true if check() returned true, false if it's time to go to sleep
+		// ==============================================================================
+		template<class Check>
+		bool	Spin( Check &check ) const {
+			for( int i=0; i<spinCount; i++ ) {
+				if ( check() )
+					return true;
+				CpuPause();
+			}
+			for( int i=0; i<yieldCount; i++ ) {
+				ogst::this_thread::yield();
+				if ( check() )
+					return true;
+			}
+			return false;
+		}
+
+		int		spinCount;	//!< Number of checks with a cpu pause in between
+		int		yieldCount;	//!< Number of checks after giving up the time slice
+	};
+
 	// ==============================================================================
 	//! Condition together with a mutex
 	// ==============================================================================
@@ -118,26 +175,76 @@ namespace og {
 			ogst::lock_guard<ogst::mutex> lock2(mutex);
 			condition.notify_one();
 		}
+
+		// ==============================================================================
+		//! Signal all waiters ( notify_all ), the mutex must already be locked by the caller
+		//!
+		//! @note	Use this when the waiter may destroy the condition as soon as it wakes up
+		// ==============================================================================
+		void	SignalAllLocked( void ) {
+			condition.notify_all();
+		}
 	};
 
 	// ==============================================================================
 	//! Shared mutex ( single writer multi reader )
+	//!
+	//! Writers are preferred: once a writer waits, new readers wait until it is done.
+	//!
+	//! In striped mode readers only touch a reader counter of their own ( picked per thread ),
+	//! so readers on different cores don't fight over one cache line.
+	//! Writers have to check all counters, which makes them more expensive.
+	//! Use it for locks that are read very often and written rarely.
 	// ==============================================================================
 	class SharedMutex {
 	private:
+		// ==============================================================================
+		//! A reader counter on its own cache line
+		// ==============================================================================
+		struct ReaderStripe {
+			AtomicInt	count;	//!< Number of shared locks on this stripe
+			char		pad[OG_CACHE_LINE_SIZE - sizeof(AtomicInt)];
+		};
+
 		ogst::mutex	mutex;						//!< The mutex
 		bool		exclusive;					//!< Exclusively locked
 		int			exclusiveRequests;			//!< Number of exclusive locks requested
 												//! (waiting for the shared locks to be done)
-		int			numShared;					//!< Number of shared locks
+		int			numShared;					//!< Number of shared locks ( not striped )
 		ogst::condition_variable exclusiveCond;	//!< The exclusive condition
 		ogst::condition_variable sharedCond;	//!< The shared condition
 
+		ReaderStripe *stripes;					//!< The reader counters, NULL if not striped
+		int			stripeMask;					//!< Number of stripes - 1
+		AtomicInt	writerActive;				//!< 1 while a writer holds or waits for the lock ( striped )
+
+		// ==============================================================================
+		//! Get the reader counter of the calling thread
+		// ==============================================================================
+		AtomicInt &	GetStripe( void );
+
+		// ==============================================================================
+		//! Release a shared lock on a stripe and wake up a waiting writer if it was the last one
+		// ==============================================================================
+		void		ReleaseStripe( AtomicInt &count );
+
+		// ==============================================================================
+		//! Check if any stripe has readers
+		// ==============================================================================
+		bool		HasStripedReaders( void ) const;
+
 	public:
 		// ==============================================================================
-		//! Default constructor
+		//! Constructor
+		//!
+		//! @param	striped	true to use one reader counter per core instead of a shared one
 		// ==============================================================================
-		SharedMutex() : exclusive(false), exclusiveRequests(0), numShared(0) {}
+		SharedMutex( bool striped=false );
+
+		// ==============================================================================
+		//! Destructor
+		// ==============================================================================
+		~SharedMutex();
 
 		// ==============================================================================
 		//! Lock shared ( for reading )
@@ -185,6 +292,108 @@ namespace og {
 		SharedMutex &mutex;	//!< The mutex
 	};
 
+	// ==============================================================================
+	//! Processor topology: logical cpus, physical cores, packages and NUMA nodes
+	//!
+	//! Physical cores are numbered by node, then package, so neighbouring cores share a node.
+	//! Only cpus the process is allowed to run on are listed.
+	// ==============================================================================
+	class CpuTopology {
+	public:
+		// ==============================================================================
+		//! Get the topology, probed on the first call
+		//!
+		//! @return	The topology
+		// ==============================================================================
+		static const CpuTopology &Get( void );
+
+		// ==============================================================================
+		//! Get the number of logical cpus ( hardware threads )
+		//!
+		//! @return	The number of logical cpus
+		// ==============================================================================
+		int		GetNumCpus( void ) const { return numCpus; }
+
+		// ==============================================================================
+		//! Get the number of physical cores
+		//!
+		//! @return	The number of physical cores
+		// ==============================================================================
+		int		GetNumCores( void ) const { return numCores; }
+
+		// ==============================================================================
+		//! Get the number of NUMA nodes
+		//!
+		//! @return	The number of NUMA nodes
+		// ==============================================================================
+		int		GetNumNodes( void ) const { return numNodes; }
+
+		// ==============================================================================
+		//! Get a logical cpu of a physical core
+		//!
+		//! @param	core	The physical core
+		//! @param	thread	The hardware thread within the core ( SMT )
+		//!
+		//! @return	The logical cpu id, -1 if there is no such cpu
+		// ==============================================================================
+		int		GetCoreCpu( int core, int thread=0 ) const;
+
+		// ==============================================================================
+		//! Get the NUMA node of a physical core
+		//!
+		//! @param	core	The physical core
+		//!
+		//! @return	The node, -1 if there is no such core
+		// ==============================================================================
+		int		GetCoreNode( int core ) const;
+
+		// ==============================================================================
+		//! Spread threads over the physical cores
+		//!
+		//! The first hardware thread of each core gets used before the second ones.
+		//!
+		//! @param	index		The thread index
+		//! @param	firstCore	The first physical core to use, the ones before stay free
+		//!
+		//! @return	The logical cpu id, -1 if there are more threads than logical cpus to use
+		// ==============================================================================
+		int		GetSpreadCpu( int index, int firstCore=0 ) const;
+
+	private:
+		// ==============================================================================
+		//! A logical cpu
+		// ==============================================================================
+		struct LogicalCpu {
+			int		id;			//!< The os cpu id
+			int		package;	//!< The physical package ( socket )
+			int		coreId;		//!< The core id within the package
+			int		node;		//!< The NUMA node
+			int		core;		//!< The physical core index
+		};
+
+		// ==============================================================================
+		//! Constructor, probes the topology
+		// ==============================================================================
+		CpuTopology();
+
+		// ==============================================================================
+		//! Fill the cpu list, implemented per platform
+		// ==============================================================================
+		void	PlatformProbe( void );
+
+		// ==============================================================================
+		//! Add a logical cpu, keeps them sorted by node, package, core id and cpu id ( used by PlatformProbe )
+		// ==============================================================================
+		void	AddCpu( int id, int package, int coreId, int node );
+
+		static const int MAX_CPUS = 256;	//!< Maximum number of logical cpus
+
+		LogicalCpu	cpus[MAX_CPUS];	//!< The logical cpus, sorted by physical core
+		int			numCpus;		//!< The number of logical cpus
+		int			numCores;		//!< The number of physical cores
+		int			numNodes;		//!< The number of NUMA nodes
+	};
+
 	// ==============================================================================
 	//! Thread
 	// ==============================================================================
@@ -255,9 +464,62 @@ namespace og {
 		virtual void	Stop( bool blocking=true );
 
 		// ==============================================================================
-		//! Wake up from hibernation to do handle new events ( signals wakeUpEvent )
+		//! Wake up from hibernation to do handle new events
+		//!
+		//! Only signals wakeUpEvent if the thread is sleeping in WaitForWakeUp(),
+		//! otherwise the next WaitForWakeUp() returns right away.
+		// ==============================================================================
+		virtual void	WakeUp( void );
+
+		// ==============================================================================
+		//! Set how the thread waits in WaitForWakeUp()
+		//!
+		//! @param	policy	The wait policy
+		// ==============================================================================
+		void			SetWaitPolicy( const WaitPolicy &policy ) { waitPolicy = policy; }
+
+		// ==============================================================================
+		//! Pin the thread to a logical cpu
+		//!
+		//! @param	cpu	The logical cpu id ( see CpuTopology ), -1 to allow all cpus
+		//!
+		//! @note	Call before Start or from within the thread
+		// ==============================================================================
+		void			SetAffinity( int cpu );
+
+		// ==============================================================================
+		//! Get the logical cpu the thread is pinned to
+		//!
+		//! @return	The logical cpu id, -1 if not pinned
 		// ==============================================================================
-		virtual void	WakeUp( void ) { wakeUpEvent.Signal(); }
+		int				GetAffinity( void ) const { return affinity; }
+
+		// ==============================================================================
+		//! Pin the calling thread to a logical cpu, for threads not created by og::Thread
+		//!
+		//! @param	cpu	The logical cpu id ( see CpuTopology ), -1 to allow all cpus
+		//!
+		//! @return	false if the os refused or does not support it
+		// ==============================================================================
+		static bool		SetCurrentAffinity( int cpu );
+
+		// ==============================================================================
+		//! Run the thread with a lower os priority, so it yields to normal threads
+		//!
+		//! @param	low	true for a lower priority, false for the normal priority
+		//!
+		//! @note	Call before Start or from within the thread
+		// ==============================================================================
+		void			SetLowPriority( bool low );
+
+		// ==============================================================================
+		//! Set the os priority of the calling thread, for threads not created by og::Thread
+		//!
+		//! @param	low	true for a lower priority, false for the normal priority
+		//!
+		//! @return	false if the os refused or does not support it
+		// ==============================================================================
+		static bool		SetCurrentLowPriority( bool low );
 
 	protected:
 #if OG_WIN32
@@ -270,9 +532,32 @@ namespace og {
 		bool		isRunning;		//!< true if the thread is still running
 		bool		keepRunning;	//!< when this is false, the thread needs to break out of its loop
 		Condition	wakeUpEvent;	//!< Time to wake up and do stuff
+		WaitPolicy	waitPolicy;		//!< How to wait in WaitForWakeUp()
+
+		// ==============================================================================
+		//! Wait until WakeUp() gets called, spins and yields first according to the wait policy
+		//!
+		//! @param	ms	Maximum time to sleep in milliseconds, -1 to sleep until woken up
+		//!
+		//! @return	true if woken up, false if the time ran out
+		//!
+		//! @note	A WakeUp() while the thread was busy is not lost, the next call returns right away
+		// ==============================================================================
+		bool		WaitForWakeUp( int ms=-1 );
 
 	private:
 		String		name;			//!< The thread name
+		int			affinity;		//!< The logical cpu to pin to, -1 for none
+		bool		lowPriority;	//!< Run with a lower os priority
+		AtomicInt	wakeUpState;	//!< WAKEUP_EMPTY, WAKEUP_NOTIFIED or WAKEUP_SLEEPING
+
+		// ==============================================================================
+		//! Check for a pending WakeUp() and consume it
+		//!
+		//! @return	true if there was one
+		// ==============================================================================
+		bool		ConsumeWakeUp( void );
+		friend class ConsumeWakeUpCheck;
 		bool		initResult;		//!< The result of Init()
 		bool		initIsDone;		//!< true when Init() has finished
 		bool		selfDestruct;	//!< Set to true if it should selfdestruct when done
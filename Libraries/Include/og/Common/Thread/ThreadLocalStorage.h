@@ -32,10 +32,25 @@
 
 #include <og/Shared.h>
 
+// Compiler thread local storage, used to skip the os lookup in TLS<T>::Get
+#if defined(_MSC_VER)
+	#define OG_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) && !OG_MACOS_X
+	#define OG_THREAD_LOCAL __thread
+#endif
+
 //! Open Game Libraries
 namespace og {
 //! @defgroup Common Common (Library)
 //! @{
+	class TLS_Data;
+
+#ifdef OG_THREAD_LOCAL
+	//! TLS data of the current thread by TLS_Index slot, a cache of the os TLS values
+	extern OG_THREAD_LOCAL TLS_Data **	tlsFastSlots;
+	//! Size of tlsFastSlots
+	extern OG_THREAD_LOCAL int			tlsNumFastSlots;
+#endif
 
 	// ==============================================================================
 	//! TLS index
@@ -73,8 +88,16 @@ namespace og {
 		// ==============================================================================
 		void	SetValue( void *value ) const;
 
+		// ==============================================================================
+		//! Get the slot in the fast lookup table
+		//!
+		//! @return	A number unique to this index
+		// ==============================================================================
+		int		GetSlot( void ) const { return slot; }
+
 	private:
 		void	*data;	//!< A pointer to the platform specific index data
+		int		slot;	//!< The slot in tlsFastSlots
 	};
 
 	// ==============================================================================
@@ -120,6 +143,9 @@ namespace og {
 	// ==============================================================================
 	//! Thread Local Storage
 	//!
+	//! The value gets created on the first access of each thread and deleted when the thread ends.
+	//! Where the compiler supports thread local variables, Get() finds it without asking the os.
+	//!
 	//! @warning	Only use together with og::Thread
 	// ==============================================================================
 	template<typename type>
@@ -167,6 +193,11 @@ namespace og {
 		//! @return	NULL if the TLS index was invalid
 		// ==============================================================================
 		type *Get( void ) const {
+#ifdef OG_THREAD_LOCAL
+			int slot = index.GetSlot();
+			if ( slot < tlsNumFastSlots && tlsFastSlots[slot] != NULL )
+				return &static_cast<TLS_DataEx *>( tlsFastSlots[slot] )->value;
+#endif
 			OG_ASSERT( index.IsValid() );
 			if ( index.IsValid() ) {
 				TLS_DataEx *data = static_cast<TLS_DataEx *>( index.GetValue() );
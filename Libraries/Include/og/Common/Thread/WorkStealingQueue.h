@@ -0,0 +1,157 @@
+// ==============================================================================
+//! @file
+//! @brief	Work Stealing Queue
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+//! @note	Based on "Dynamic Circular Work-Stealing Deque" by David Chase and Yossi Lev
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+#ifndef __OG_WORK_STEALING_QUEUE_H__
+#define __OG_WORK_STEALING_QUEUE_H__
+
+#include <og/Common/Thread/Atomic.h>
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Common Common (Library)
+//! @{
+
+	// ==============================================================================
+	//! Fixed size work stealing deque
+	//!
+	//! The owner thread pushes and pops at the bottom ( LIFO ),
+	//! any other thread may steal from the top ( FIFO ).
+	// ==============================================================================
+	template<typename type>
+	class WorkStealingQueue {
+	public:
+		// ==============================================================================
+		//! Constructor
+		//!
+		//! @param	size	The maximum number of elements, will be rounded up to a power of two
+		// ==============================================================================
+		WorkStealingQueue( int size=256 ) {
+			int capacity = 1;
+			while( capacity < size )
+				capacity <<= 1;
+			mask = capacity - 1;
+			buffer = new type *[capacity];
+		}
+
+		// ==============================================================================
+		//! Destructor
+		// ==============================================================================
+		~WorkStealingQueue() {
+			delete[] buffer;
+		}
+
+		// ==============================================================================
+		//! Add an entry at the bottom ( owner thread only )
+		//!
+		//! @param	data	A pointer to the object
+		//!
+		//! @return	false if the queue is full
+		// ==============================================================================
+		bool	Push( type *data ) {
+			int b = bottom.Get();
+			if ( Distance( top.Get(), b ) > mask )
+				return false;
+			buffer[b & mask] = data;
+			bottom.Set( b + 1 );
+			return true;
+		}
+
+		// ==============================================================================
+		//! Remove the newest entry from the bottom ( owner thread only )
+		//!
+		//! @return	NULL if the queue is empty, otherwise the entry
+		// ==============================================================================
+		type *	Pop( void ) {
+			int b = bottom.Get() - 1;
+			bottom.Set( b );
+			MemoryFence();
+			int t = top.Get();
+			int size = Distance( t, b + 1 );
+			if ( size <= 0 ) {
+				bottom.Set( b + 1 );
+				return NULL;
+			}
+			type *data = buffer[b & mask];
+			if ( size > 1 )
+				return data;
+
+			// Last entry, race against the thieves
+			if ( top.CompareExchange( t + 1, t ) != t )
+				data = NULL;
+			bottom.Set( b + 1 );
+			return data;
+		}
+
+		// ==============================================================================
+		//! Remove the oldest entry from the top ( any thread )
+		//!
+		//! @return	NULL if the queue is empty or another thread was faster, otherwise the entry
+		// ==============================================================================
+		type *	Steal( void ) {
+			int t = top.Get();
+			MemoryFence();
+			int b = bottom.Get();
+			if ( Distance( t, b ) <= 0 )
+				return NULL;
+			type *data = buffer[t & mask];
+			if ( top.CompareExchange( t + 1, t ) != t )
+				return NULL;
+			return data;
+		}
+
+		// ==============================================================================
+		//! Check if the queue is empty, only a snapshot when used by a thief
+		//!
+		//! @return	true if empty, false if not
+		// ==============================================================================
+		bool	IsEmpty( void ) const {
+			return Distance( top.Get(), bottom.Get() ) <= 0;
+		}
+
+	private:
+		// ==============================================================================
+		//! Get the distance between two indices, safe for overflowing indices
+		// ==============================================================================
+		static int Distance( int from, int to ) {
+			return static_cast<int>( static_cast<uInt>(to) - static_cast<uInt>(from) );
+		}
+
+		AtomicInt	top;		//!< The next entry to steal
+		char		padTop[OG_CACHE_LINE_SIZE - sizeof(AtomicInt)];
+		AtomicInt	bottom;		//!< The next free slot of the owner
+		char		padBottom[OG_CACHE_LINE_SIZE - sizeof(AtomicInt)];
+		type **		buffer;		//!< The ring buffer
+		int			mask;		//!< Capacity - 1
+	};
+
+	//! @}
+}
+
+#endif
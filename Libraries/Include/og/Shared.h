@@ -33,6 +33,7 @@
 #include <og/Setup.h>
 
 // Public Library Includes
+#include <og/Shared/MemoryAllocator.h>
 #include <og/Shared/String.h>
 #include <og/Shared/Format.h>
 #include <og/Shared/SysInfo.h>
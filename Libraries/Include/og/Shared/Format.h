@@ -78,9 +78,17 @@ namespace og {
 	//! @li $+23*	=> Left aligned text, fill up 23 fillChars on the right
 	//! @li $-23*	=> Right aligned text, fill up 23 fillChars on the left
 	//! @li $?*		=> Accepts an extra input value, but works like the 2 above
+	//!
+	//! The format gets parsed once into a fixed table, so nothing gets allocated unless
+	//! the result outgrows the inline buffer. Use Reset() to reuse a parsed format in loops.
 	// ==============================================================================
 	class Format {
 	public:
+		static const int INLINE_SIZE	= 512;		//!< Size of the inline buffer
+		static const int MAX_SIZE		= 16384;	//!< Maximum size the buffer may grow to
+		static const int MAX_ENTRIES	= 16;		//!< Maximum number of parameters in a format
+		static const int FMT_SIZE		= 256;		//!< Maximum length of a format
+
 		// ==============================================================================
 		//! Constructor
 		//!
@@ -88,10 +96,29 @@ namespace og {
 		// ==============================================================================
 		Format( const char *fmt = NULL );
 
+		// ==============================================================================
+		//! Constructor, writes into a caller supplied buffer
+		//!
+		//! @param	dest	The buffer to write to, it will not be resized
+		//! @param	size	Size of dest in bytes
+		//! @param	fmt		Describes the format to use
+		// ==============================================================================
+		Format( char *dest, int size, const char *fmt = NULL );
+
+		// ==============================================================================
+		//! Copy constructor
+		// ==============================================================================
+		Format( const Format &other );
+
 		// ==============================================================================
 		//! Destructor
 		// ==============================================================================
 		~Format();
+
+		// ==============================================================================
+		//! Copy the format and the text written so far
+		// ==============================================================================
+		Format &operator=( const Format &other );
 		
 		// ==============================================================================
 		//! Reset the values already entered and (optional) the format
@@ -162,11 +189,40 @@ namespace og {
 		Format &operator << ( const SetPrecision &value ) { floatPrecision = value.floatPrecision; return *this; }
 
 	protected:
+		// ==============================================================================
+		//! Parse the format into fmtBuffer and the format entries
+		// ==============================================================================
+		void	Parse( const char *fmt );
 
 		// ==============================================================================
-		//! Remove all format entries
+		//! Copy the format and the text of another object
 		// ==============================================================================
-		void	DeleteFormatEntries( void );
+		void	Copy( const Format &other );
+
+		// ==============================================================================
+		//! Make room for more bytes, grows the buffer if possible
+		//!
+		//! @param	len	The number of bytes to be appended
+		//!
+		//! @return	The number of bytes that can be appended ( up to len )
+		// ==============================================================================
+		int		Reserve( int len );
+
+		// ==============================================================================
+		//! Append text, call Error if it does not fit
+		//!
+		//! @param	str			The text to append
+		//! @param	len			Byte length of str
+		//! @param	fieldWidth	Field width ( fill up the rest with fillChar, align right if negative )
+		// ==============================================================================
+		void	Append( const char *str, int len, int fieldWidth );
+
+		// ==============================================================================
+		//! Append a value, using the field width of the current format entry
+		// ==============================================================================
+		void	AppendValue( const char *str, int len ) {
+			Append( str, len, ( paramCount >= 0 && paramCount < numFormatEntries ) ? entries[paramCount].fieldWidth : 0 );
+		}
 
 		// ==============================================================================
 		//! Finished the formating after appending a value
@@ -184,28 +240,28 @@ namespace og {
 		//! @todo	Move float precision here too ?
 		// ==============================================================================
 		struct FormatEntry {
-			FormatEntry() : append(NULL), fieldWidth(0), takeInput(0), next(NULL) {}
-
-			const char *append;		//!< What to append after getting input
-			int			fieldWidth;	//!< Field width ( fill up the rest with fillChar, align right if negative )
-			int			takeInput;	//!< Accept variable input instead of a fixed value
-			FormatEntry *next;		//!< The next format entry
+			int		append;			//!< Offset into fmtBuffer of what to append after getting input
+			int		appendLength;	//!< Byte length of what to append
+			int		fieldWidth;		//!< Field width ( fill up the rest with fillChar, align right if negative )
+			int		takeInput;		//!< Accept variable input instead of a fixed value
 		};
-		FormatEntry *GetFormatEntry( int index );
 
-		static const int bufferSize = 16384;	//!< Size of the buffer
-		char	buffer[bufferSize];	//!< The buffer
+		char *	buffer;				//!< The buffer, inlineBuffer, a heap buffer or the callers buffer
+		int		bufferSize;			//!< Size of the buffer
 		int		offset;				//!< The offset into the buffer
+		bool	fixedSize;			//!< true if the buffer belongs to the caller
 
-		char	fmtBuffer[256];		//!< Format buffer
-		FormatEntry *firstFormatEntry;//!< First format entry
-		FormatEntry *lastFormatEntry;//!< Last format entry
+		char	fmtBuffer[FMT_SIZE];//!< Literal text of the format, without the parameters
+		int		prefixLength;		//!< Byte length of the text before the first parameter
+		FormatEntry entries[MAX_ENTRIES];//!< The format entries
 		int		numFormatEntries;	//!< Number of format entries
 		bool	hasFormat;			//!< true if it has format
 		int		paramCount;			//!< Number of parameters to be expected
 		char	fillChar;			//!< The character to use to fill up
 
 		int		floatPrecision;		//!< The float precision
+
+		char	inlineBuffer[INLINE_SIZE];//!< Used until the text outgrows it
 	};
 
 //! @}
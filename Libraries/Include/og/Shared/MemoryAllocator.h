@@ -0,0 +1,101 @@
+// ==============================================================================
+//! @file
+//! @brief	Interface for memory allocators
+//! @author	Santo Pfingsten (TTK-Bandit)
+//! @note	Copyright (C) 2007-2010 Lusito Software
+// ==============================================================================
+//
+// The Open Game Libraries.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// ==============================================================================
+
+
+#ifndef __OG_MEMORY_ALLOCATOR_H__
+#define __OG_MEMORY_ALLOCATOR_H__
+
+#include <new>
+#include <cstddef>
+
+//! Open Game Libraries
+namespace og {
+//! @defgroup Shared Shared (Library)
+//! @{
+
+	// ==============================================================================
+	//! Interface for memory allocators
+	//!
+	//! Strings and containers can get their memory from an allocator instead of the heap,
+	//! see og::FrameAllocator for per frame scratch memory.
+	// ==============================================================================
+	class MemoryAllocator {
+	public:
+		// ==============================================================================
+		//! Virtual destructor
+		// ==============================================================================
+		virtual ~MemoryAllocator() {}
+
+		// ==============================================================================
+		//! Allocate memory
+		//!
+		//! @param	size	The size in bytes
+		//!
+		//! @return	Pointer to the memory, aligned to 16 bytes
+		// ==============================================================================
+		virtual void *	Alloc( size_t size ) = 0;
+
+		// ==============================================================================
+		//! Give memory back
+		//!
+		//! @param	ptr		Pointer returned by Alloc, may be NULL
+		//! @param	size	The size passed to Alloc
+		// ==============================================================================
+		virtual void	Free( void *ptr, size_t size ) = 0;
+	};
+
+	// ==============================================================================
+	//! Allocate memory from an allocator
+	//!
+	//! @param	allocator	The allocator, NULL for the heap
+	//! @param	size		The size in bytes
+	//!
+	//! @return	Pointer to the memory
+	// ==============================================================================
+	OG_INLINE void *MemAlloc( MemoryAllocator *allocator, size_t size ) {
+		return allocator ? allocator->Alloc( size ) : ::operator new( size );
+	}
+
+	// ==============================================================================
+	//! Give memory back to an allocator
+	//!
+	//! @param	allocator	The allocator it came from, NULL for the heap
+	//! @param	ptr			Pointer to the memory, may be NULL
+	//! @param	size		The size passed to MemAlloc
+	// ==============================================================================
+	OG_INLINE void MemFree( MemoryAllocator *allocator, void *ptr, size_t size ) {
+		if ( allocator )
+			allocator->Free( ptr, size );
+		else
+			::operator delete( ptr );
+	}
+//! @}
+}
+
+#endif
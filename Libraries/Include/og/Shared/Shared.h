@@ -205,6 +205,13 @@ namespace og {
 	// ==============================================================================
 	uInt		FNV32( const char *value, bool caseSensitive );
 
+	// ==============================================================================
+	//! @overload
+	//!
+	//! @param	byteLength		The number of bytes to hash, value does not need to be null-terminated
+	// ==============================================================================
+	uInt		FNV32( const char *value, int byteLength, bool caseSensitive );
+
 	// ==============================================================================
 	//! FNV Hash 64 bit
 	//!
@@ -38,6 +38,13 @@ namespace og {
 //! @{
 
 	class File;
+	class StringView;
+
+//! The size of a String object, the space left after the members is used as hardbuffer.
+//! The default fills a cache line, define it before including to change it.
+#ifndef OG_STRING_SIZE
+	#define OG_STRING_SIZE 64
+#endif
 
 	// ==============================================================================
 	//! String class ( UTF-8 )
@@ -51,7 +58,7 @@ namespace og {
 	class String {
 	public:
 		static const int INVALID_POSITION	= -1;	//!< Name for an invalid position ( returned by Find )
-		static const int HARDBUFFER_SIZE	= 20;	//!< Size of the string hardbuffer ( strings below this bytelength don't need dynamic memory )
+		static const int HARDBUFFER_SIZE	= OG_STRING_SIZE - 2 * sizeof(void *) - 3 * sizeof(int);	//!< Size of the string hardbuffer ( strings below this bytelength don't need dynamic memory )
 		static const int GRANULARITY		= 16;	//!< The string granularity
 		static const int FILE_MAX_BYTES		= 65534;//!< The maximum bytelength of a string in a file
 
@@ -75,9 +82,18 @@ namespace og {
 		String( const String &str );
 
 		// ==============================================================================
-		//! Virtual destructor
+		//! Constructor
+		//!
+		//! @param	view	The initial value
+		// ==============================================================================
+		explicit String( const StringView &view );
+
+		// ==============================================================================
+		//! Destructor
+		//!
+		//! @note	Not virtual, don't delete derived classes through a String pointer
 		// ==============================================================================
-		virtual ~String();
+		~String();
 
 		// ==============================================================================
 		//! Frees dynamic memory and sets the hardbuffer to ""
@@ -86,6 +102,31 @@ namespace og {
 		// ==============================================================================
 		void			Clear( void );
 
+		// ==============================================================================
+		//! Move the content to another string and clear this one
+		//!
+		//! Dynamic memory gets handed over instead of being copied.
+		//!
+		//! @param	other	The string to receive the content
+		// ==============================================================================
+		void			MoveTo( String &other );
+
+		// ==============================================================================
+		//! Set where dynamic memory comes from, this clears the string
+		//!
+		//! Copies of this string use the heap again.
+		//!
+		//! @param	allocator	The allocator, NULL for the heap
+		// ==============================================================================
+		void			SetAllocator( MemoryAllocator *allocator );
+
+		// ==============================================================================
+		//! Get the allocator dynamic memory comes from
+		//!
+		//! @return	The allocator, NULL for the heap
+		// ==============================================================================
+		MemoryAllocator *GetAllocator( void ) const { return allocator; }
+
 		// ==============================================================================
 		//! Returns the C-String
 		//!
@@ -328,6 +369,13 @@ namespace og {
 		// ==============================================================================
 		int				Find( const char *text, bool caseSensitive=true, int start=0 ) const;
 
+		// ==============================================================================
+		//! @overload
+		//!
+		//! @return	The byte position of the first occurence, INVALID_POSITION if not found
+		// ==============================================================================
+		int				Find( const StringView &text, bool caseSensitive=true, int start=0 ) const;
+
 		// ==============================================================================
 		//! @overload
 		//!
@@ -630,6 +678,11 @@ namespace og {
 		// ==============================================================================
 		int				Cmp( const char *text ) const;
 
+		// ==============================================================================
+		//! @overload
+		// ==============================================================================
+		int				Cmp( const StringView &text ) const;
+
 		// ==============================================================================
 		//! @overload
 		//!
@@ -688,6 +741,11 @@ namespace og {
 		// ==============================================================================
 		int				Icmp( const char *text ) const;
 
+		// ==============================================================================
+		//! @overload
+		// ==============================================================================
+		int				Icmp( const StringView &text ) const;
+
 		// ==============================================================================
 		//! @overload
 		//!
@@ -895,6 +953,11 @@ namespace og {
 		// ==============================================================================
 		String &		operator=( const String &str );
 
+		// ==============================================================================
+		//! @overload
+		// ==============================================================================
+		String &		operator=( const StringView &view );
+
 		// ==============================================================================
 		//! Append a string to this one
 		//!
@@ -945,10 +1008,11 @@ namespace og {
 	protected:
 		friend class	StringList;
 
+		char *			data;							//!< The pointer to the buffer ( can point to hardBuffer )
+		MemoryAllocator *allocator;						//!< Where dynamic memory comes from, NULL for the heap
 		int				size;							//!< The current buffer size
 		int				length;							//!< How many characters the string consists of ( excluding the termination )
 		int				byteLength;						//!< How many bytes the string consists of ( excluding the termination )
-		char *			data;							//!< The pointer to the buffer ( can point to hardBuffer )
 		char			hardBuffer[HARDBUFFER_SIZE];	//!< Hard buffer: if string is below HARDBUFFER_SIZE it will use the hardbuffer
 														//!  Otherwise dynamic memory will be allocated.
 
@@ -997,6 +1061,52 @@ namespace og {
 		void			AppendData( const char *text, int byteLength, int length );
 	};
 
+	// ==============================================================================
+	//! Non-owning view on a part of a string
+	//!
+	//! Does not need to be null-terminated, so parts of a buffer can be compared,
+	//! searched for or stored without creating a temporary String.
+	//! The viewed text must stay alive as long as the view is used.
+	// ==============================================================================
+	class StringView {
+	public:
+		// ==============================================================================
+		//! Constructors
+		//!
+		//! @param	text		The text, NULL is treated like ""
+		//! @param	byteLength	The number of bytes to view
+		// ==============================================================================
+		StringView() : text(""), byteLength(0) {}
+		StringView( const char *text );
+		StringView( const char *text, int byteLength ) : text(text), byteLength(byteLength) {}
+		StringView( const String &str ) : text(str.c_str()), byteLength(str.ByteLength()) {}
+
+		// ==============================================================================
+		//! Get the text
+		//!
+		//! @return	Pointer to the first byte, not null-terminated
+		// ==============================================================================
+		const char *	GetData( void ) const { return text; }
+
+		// ==============================================================================
+		//! Get the number of bytes
+		//!
+		//! @return	The bytelength
+		// ==============================================================================
+		int				ByteLength( void ) const { return byteLength; }
+
+		// ==============================================================================
+		//! Check if the view is empty
+		//!
+		//! @return	true if no bytes are viewed
+		// ==============================================================================
+		bool			IsEmpty( void ) const { return byteLength == 0; }
+
+	private:
+		const char *	text;		//!< The viewed text
+		int				byteLength;	//!< The number of bytes
+	};
+
 	// ==============================================================================
 	//! StringType - A helper for Dict return value conversion
 	// ==============================================================================
@@ -280,7 +280,7 @@ String::Free
 */
 OG_INLINE void String::Free( void ) {
 	if ( data && data != hardBuffer )
-		delete[] data;
+		MemFree( allocator, data, size );
 }
 
 /*
@@ -389,6 +389,29 @@ OG_INLINE String operator+( const char *text, const String &str ) {
 	return ret;
 }
 
+/*
+==============================================================================
+
+  StringView
+
+==============================================================================
+*/
+
+/*
+================
+StringView::StringView
+================
+*/
+OG_INLINE StringView::StringView( const char *_text ) {
+	if ( _text ) {
+		text = _text;
+		byteLength = static_cast<int>( String::ByteLength( _text ) );
+	} else {
+		text = "";
+		byteLength = 0;
+	}
+}
+
 }
 
 #endif
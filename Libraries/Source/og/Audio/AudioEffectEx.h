@@ -64,7 +64,7 @@ namespace og {
 		uInt	alEffectSlotNum;
 		int		alEffectType;
 		uInt	alEffectNum;
-		LinkedList<AudioEffectEx>::nodeType *node;
+		SlotHandle	handle;
 	};
 
 }
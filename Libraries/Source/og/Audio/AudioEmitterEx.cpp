@@ -31,6 +31,15 @@
 
 namespace og {
 
+// Coalesce types of the emitter property events
+enum EmitterProperty {
+	EP_RELATIVE,
+	EP_POSITION,
+	EP_VELOCITY,
+	EP_DIRECTIONAL,
+	EP_EFFECT
+};
+
 /*
 ==============================================================================
 
@@ -43,6 +52,13 @@ public:
 	EE_Base( AudioEmitterEx *emt ) : emitter(emt) {}
 
 protected:
+	// Use in property events, so only the last change within a batch gets executed
+	bool	Coalesce( int property, const void *&object, int &type ) const {
+		object = emitter;
+		type = property;
+		return true;
+	}
+
 	AudioEmitterEx *emitter;
 };
 
@@ -167,6 +183,7 @@ public:
 	EE_SetRelative( AudioEmitterEx *emt, bool val ) : EE_Update(emt), value(val) {}
 
 	void	Execute( void )  { emitter->details.relative = value; Update(); }
+	bool	GetCoalesceKey( const void *&object, int &type ) const { return Coalesce( EP_RELATIVE, object, type ); }
 
 private:
 	bool	value;
@@ -184,6 +201,7 @@ public:
 	EE_SetPosition( AudioEmitterEx *emt, const Vec3 &val ) : EE_Update(emt), value(val) {}
 
 	void	Execute( void )  { emitter->details.origin = value; Update(); }
+	bool	GetCoalesceKey( const void *&object, int &type ) const { return Coalesce( EP_POSITION, object, type ); }
 
 private:
 	Vec3	value;
@@ -201,6 +219,7 @@ public:
 	EE_SetVelocity( AudioEmitterEx *emt, const Vec3 &val ) : EE_Update(emt), value(val) {}
 
 	void	Execute( void )  { emitter->details.velocity = value; Update(); }
+	bool	GetCoalesceKey( const void *&object, int &type ) const { return Coalesce( EP_VELOCITY, object, type ); }
 
 private:
 	Vec3	value;
@@ -225,6 +244,7 @@ public:
 		emitter->details.outerVolume = outerVolume;
 		Update();
 	}
+	bool	GetCoalesceKey( const void *&object, int &type ) const { return Coalesce( EP_DIRECTIONAL, object, type ); }
 
 private:
 	Vec3	direction;
@@ -256,6 +276,7 @@ public:
 		}
 		emitter->mutex.unlock();
 	}
+	bool	GetCoalesceKey( const void *&object, int &type ) const { return Coalesce( EP_EFFECT, object, type ); }
 
 private:
 	AudioEffectEx *effect;
@@ -89,7 +89,7 @@ namespace og {
 		AudioEffectEx *	effect;
 
 		ogst::mutex		mutex;
-		LinkedList<AudioEmitterEx>::nodeType *node;
+		SlotHandle	handle;
 	};
 
 }
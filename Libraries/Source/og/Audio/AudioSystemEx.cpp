@@ -98,7 +98,6 @@ void AudioThread::Run( void ) {
 		Shutdown();
 		return false;
 	}*/
-	wakeUpEvent.Lock();
 	while( keepRunning ) {
 		eventQueue.ProcessAll();
 
@@ -122,9 +121,8 @@ void AudioThread::Run( void ) {
 		}
 
 		// Wait for an event or 20ms passed
-		wakeUpEvent.Wait(20);
+		WaitForWakeUp(20);
 	}
-	wakeUpEvent.Unlock();
 
 	// Consume remaining events
 	eventQueue.ProcessAll();
@@ -246,6 +244,7 @@ bool AudioSystemEx::Init( const char *defaultFilename, const char *deviceName )
 	maxVariations = 0;
 
 	audioThread = new AudioThread( defaultStream );
+	audioThread->SetWaitPolicy( WaitPolicy::LowLatency() );
 	audioThread->Start("AudioThread");
 
 	return true;
@@ -262,8 +261,16 @@ void AudioSystemEx::Shutdown( void ) {
 		audioThread = NULL;
 	}
 
+	int num = audioEmitters.Num();
+	for( int i=0; i<num; i++ )
+		delete audioEmitters[i];
 	audioEmitters.Clear();
 
+	num = audioEffects.Num();
+	for( int i=0; i<num; i++ )
+		delete audioEffects[i];
+	audioEffects.Clear();
+
 	if ( context ) {
 		alcMakeContextCurrent( NULL );
 		alcDestroyContext( context );
@@ -333,11 +340,11 @@ AudioSystemEx::CreateEmitter
 ================
 */
 AudioEmitter *AudioSystemEx::CreateEmitter( int channels ) {
+	AudioEmitterEx *emt = new AudioEmitterEx;
 	emitterLock.lock();
-	AudioEmitterEx *emt = &audioEmitters.Alloc();
+	emt->handle = audioEmitters.Add( emt );
 	emitterLock.unlock();
 
-	emt->node = audioEmitters.GetLastNode();
 	if ( channels > 0 )
 		emt->Init( channels );
 	return emt;
@@ -351,9 +358,31 @@ AudioSystemEx::FreeEmitter
 void AudioSystemEx::FreeEmitter( AudioEmitter *emitter ) {
 	OG_ASSERT( emitter != NULL );
 	
+	AudioEmitterEx *emt = static_cast<AudioEmitterEx *>(emitter);
 	emitterLock.lock();
-	audioEmitters.Remove( static_cast<AudioEmitterEx *>(emitter)->node );
+	audioEmitters.Remove( emt->handle );
 	emitterLock.unlock();
+	delete emt;
+}
+
+/*
+================
+AudioSystemEx::BeginBatch
+================
+*/
+void AudioSystemEx::BeginBatch( void ) {
+	if ( audioThread )
+		audioThread->BeginBatch();
+}
+
+/*
+================
+AudioSystemEx::FlushBatch
+================
+*/
+void AudioSystemEx::FlushBatch( void ) {
+	if ( audioThread )
+		audioThread->FlushBatch();
 }
 
 /*
@@ -362,10 +391,10 @@ AudioSystemEx::CreateEffect
 ================
 */
 AudioEffect *AudioSystemEx::CreateEffect( void ) {
+	AudioEffectEx *effect = new AudioEffectEx;
 	effectLock.lock();
-	AudioEffectEx *effect = &audioEffects.Alloc();
+	effect->handle = audioEffects.Add( effect );
 	effectLock.unlock();
-	effect->node = audioEffects.GetLastNode();
 	effect->Init();
 	return effect;
 }
@@ -378,9 +407,11 @@ AudioSystemEx::FreeEffect
 void AudioSystemEx::FreeEffect( AudioEffect *effect ) {
 	OG_ASSERT( effect != NULL );
 
+	AudioEffectEx *effectEx = static_cast<AudioEffectEx *>(effect);
 	effectLock.lock();
-	audioEffects.Remove( static_cast<AudioEffectEx *>(effect)->node );
+	audioEffects.Remove( effectEx->handle );
 	effectLock.unlock();
+	delete effectEx;
 }
 
 /*
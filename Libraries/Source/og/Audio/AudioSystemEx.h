@@ -55,7 +55,9 @@ namespace og {
 	public:
 		AudioThread( AudioStream *stream ) : firstAudioSource(NULL), defaultStream(stream) {}
 
-		void	AddEvent( QueuedEvent *evt ) { eventQueue.Add( evt ); WakeUp(); }
+		void	AddEvent( QueuedEvent *evt ) { if ( eventQueue.AddBatched( evt ) ) WakeUp(); }
+		void	BeginBatch( void ) { eventQueue.BeginBatch(); }
+		void	FlushBatch( void ) { if ( eventQueue.FlushBatch() ) WakeUp(); }
 
 		AudioSource *FindFreeAudioSource( void );
 
@@ -95,6 +97,9 @@ namespace og {
 		AudioEffect *		CreateEffect( void );
 		void				FreeEffect( AudioEffect *effect );
 
+		void				BeginBatch( void );
+		void				FlushBatch( void );
+
 		// ---------------------- Internal AudioSystemEx Members -------------------
 
 	public:
@@ -112,9 +117,9 @@ namespace og {
 		float		focusVolume;
 		float		volume;
 		int			maxVariations;
-		LinkedList<AudioEmitterEx> audioEmitters;
+		SlotMap<AudioEmitterEx *> audioEmitters;
 		ogst::mutex	emitterLock;
-		LinkedList<AudioEffectEx> audioEffects;
+		SlotMap<AudioEffectEx *> audioEffects;
 		ogst::mutex	effectLock;
 
 		ALCcontext	*context;
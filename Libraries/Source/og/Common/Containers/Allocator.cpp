@@ -0,0 +1,158 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Allocators for per frame and thread local memory
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include <og/Common.h>
+
+namespace og {
+
+/*
+==============================================================================
+
+  FrameAllocator
+
+==============================================================================
+*/
+
+/*
+================
+FrameAllocator::FrameAllocator
+================
+*/
+FrameAllocator::FrameAllocator( size_t _blockSize ) {
+	first = NULL;
+	current = NULL;
+	offset = 0;
+	used = 0;
+	blockSize = _blockSize;
+}
+
+/*
+================
+FrameAllocator::~FrameAllocator
+================
+*/
+FrameAllocator::~FrameAllocator() {
+	while( first ) {
+		Block *next = first->next;
+		::operator delete( first );
+		first = next;
+	}
+}
+
+/*
+================
+FrameAllocator::Alloc
+================
+*/
+void *FrameAllocator::Alloc( size_t size ) {
+	size = ( size + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+	if ( current == NULL || offset + size > current->size ) {
+		// Blocks after the current one are unused since the last reset
+		Block *block = current ? current->next : first;
+		while( block && block->size < size )
+			block = block->next;
+
+		if ( block == NULL ) {
+			size_t newSize = Max( blockSize, size );
+			block = static_cast<Block *>( ::operator new( ALIGNMENT + newSize ) );
+			block->size = newSize;
+			if ( current ) {
+				block->next = current->next;
+				current->next = block;
+			} else {
+				block->next = first;
+				first = block;
+			}
+		}
+		current = block;
+		offset = 0;
+	}
+
+	void *ptr = reinterpret_cast<byte *>( current ) + ALIGNMENT + offset;
+	offset += size;
+	used += size;
+	return ptr;
+}
+
+/*
+================
+FrameAllocator::Free
+================
+*/
+void FrameAllocator::Free( void *ptr, size_t size ) {
+	if ( ptr == NULL || current == NULL )
+		return;
+
+	size = ( size + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+	byte *top = reinterpret_cast<byte *>( current ) + ALIGNMENT + offset;
+	if ( static_cast<byte *>( ptr ) + size == top ) {
+		offset -= size;
+		used -= size;
+	}
+}
+
+/*
+================
+FrameAllocator::Reset
+================
+*/
+void FrameAllocator::Reset( void ) {
+	current = NULL;
+	offset = 0;
+	used = 0;
+}
+
+/*
+==============================================================================
+
+  ThreadFrameAllocator
+
+==============================================================================
+*/
+class ThreadFrameAllocator {
+public:
+	ThreadFrameAllocator() {}
+
+	// TLS copies the initial value for each thread, each one gets its own empty allocator
+	ThreadFrameAllocator( const ThreadFrameAllocator & ) {}
+
+	FrameAllocator	allocator;
+};
+static TLS<ThreadFrameAllocator> threadFrameAllocator;
+
+/*
+================
+FrameAllocator::GetThreadAllocator
+================
+*/
+FrameAllocator *FrameAllocator::GetThreadAllocator( void ) {
+	return &threadFrameAllocator->allocator;
+}
+
+}
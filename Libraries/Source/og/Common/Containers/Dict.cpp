@@ -39,8 +39,7 @@ namespace og {
 ==============================================================================
 */
 
-TLS<StringPool> Dict::keyPool;
-TLS<StringPool> Dict::valuePool;
+SharedStringPool Dict::valuePool;
 
 /*
 ================
@@ -50,8 +49,8 @@ Dict::Clear
 void Dict::Clear( void ) {
 	int num = entries.Num();
 	for( int i=0; i<num; i++ ) {
-		keyPool->Free(entries[i].key);
-		valuePool->Free(entries[i].value);
+		Name::GetPool().Free(entries[i].key);
+		valuePool.Free(entries[i].value);
 	}
 	entries.Clear();
 	hashIndex.Clear();
@@ -66,8 +65,8 @@ void Dict::Remove( const char *key ) {
 	int hash = hashIndex.GenerateKey( key, false );
 	for( int i=hashIndex.First(hash); i!=-1; i=hashIndex.Next() ) {
 		if ( entries[i].GetKey().Icmp( key ) == 0 ) {
-			keyPool->Free( entries[i].key );
-			valuePool->Free( entries[i].value );
+			Name::GetPool().Free( entries[i].key );
+			valuePool.Free( entries[i].value );
 			entries.Remove( i );
 			hashIndex.Remove( hash, i );
 			return;
@@ -81,10 +80,20 @@ Dict::Copy
 ================
 */
 void Dict::Copy( const Dict &other ) {
+	if ( &other == this )
+		return;
+
 	Clear();
+
+	// all dicts share the pools, so the strings just get another reference
 	int num = other.entries.Num();
-	for ( int i = 0; i < num; i++ )
-		Set( other.entries[i].key->c_str(), other.entries[i].value->c_str() );
+	for ( int i = 0; i < num; i++ ) {
+		KeyValue kv;
+		kv.key = Name::GetPool().Copy( other.entries[i].key );
+		kv.value = valuePool.Copy( other.entries[i].value );
+		hashIndex.Add( kv.key->GetHash(), entries.Num() );
+		entries.Append( kv );
+	}
 }
 
 /*
@@ -96,7 +105,7 @@ void Dict::Append( const Dict &other, bool overWrite ) {
 	int num = other.entries.Num();
 	for ( int i = 0; i < num; i++ ) {
 		if ( overWrite || Find( other.entries[i].key->c_str() ) == -1 )
-			Set( other.entries[i].key->c_str(), other.entries[i].value->c_str() );
+			Set( other.entries[i].key->c_str(), *other.entries[i].value );
 	}
 }
 
@@ -105,21 +114,44 @@ void Dict::Append( const Dict &other, bool overWrite ) {
 Dict::Set
 ================
 */
-void Dict::Set( const char *key, const char *value ) {
+void Dict::Set( const char *key, const StringView &value ) {
 	if ( key == NULL || key[0] == '\0' )
 		return;
 
 	int i = Find( key );
 	if ( i == -1 ) {
 		KeyValue kv;
-		kv.key = keyPool->Alloc( key );
-		kv.value = valuePool->Alloc( value );
-		hashIndex.Add( hashIndex.GenerateKey( kv.key->c_str(), false ), entries.Num() );
+		kv.key = Name::GetPool().Alloc( key );
+		kv.value = valuePool.Alloc( value );
+		hashIndex.Add( kv.key->GetHash(), entries.Num() );
 		entries.Append( kv );
 	} else {
 		const PoolString *oldValue = entries[i].value;
-		entries[i].value = valuePool->Alloc( value );
-		valuePool->Free( oldValue );
+		entries[i].value = valuePool.Alloc( value );
+		valuePool.Free( oldValue );
+	}
+}
+
+/*
+================
+Dict::Set
+================
+*/
+void Dict::Set( const Name &key, const StringView &value ) {
+	if ( key.IsEmpty() )
+		return;
+
+	int i = Find( key );
+	if ( i == -1 ) {
+		KeyValue kv;
+		kv.key = Name::GetPool().Copy( key.GetPoolString() );
+		kv.value = valuePool.Alloc( value );
+		hashIndex.Add( kv.key->GetHash(), entries.Num() );
+		entries.Append( kv );
+	} else {
+		const PoolString *oldValue = entries[i].value;
+		entries[i].value = valuePool.Alloc( value );
+		valuePool.Free( oldValue );
 	}
 }
 
@@ -134,6 +166,12 @@ StringType Dict::Get( const char *key, const char *defaultValue ) const {
 		return StringType( defaultValue );
 	return entries[index].GetValue();
 }
+StringType Dict::Get( const Name &key, const char *defaultValue ) const {
+	int index = Find( key );
+	if ( index == -1 )
+		return StringType( defaultValue );
+	return entries[index].GetValue();
+}
 
 /*
 ================
@@ -152,6 +190,19 @@ int Dict::Find( const char *key ) const {
 
 	return -1;
 }
+int Dict::Find( const Name &key ) const {
+	const PoolString *str = key.GetPoolString();
+	if ( str == NULL )
+		return -1;
+
+	// keys share the Name pool, so a key with the same spelling is the same object
+	for ( int i = hashIndex.First( str->GetHash() ); i != -1; i = hashIndex.Next() ) {
+		if ( entries[i].key == str || entries[i].key->Icmp( str->c_str() ) == 0 )
+			return i;
+	}
+
+	return -1;
+}
 
 /*
 ================
@@ -50,7 +50,8 @@ OG_INLINE bool MathIsPowerOfTwo( int x ) {
 ==============================================================================
 */
 
-//! @todo	use og::Allocator ?
+const int HASH_MAX_LOAD_NUM	= 3;	// grow when more than 3/4 of the slots are used
+const int HASH_MAX_LOAD_DEN	= 4;
 
 /*
 ================
@@ -63,8 +64,11 @@ HashIndex::HashIndex( int _hashSize ) {
 	hashSize = _hashSize;
 	mask = hashSize-1;
 	initialized = false;
-	nodeList = NULL;
-	findNode = NULL;
+	numEntries = 0;
+	slots = NULL;
+	findHash = 0;
+	findSlot = -1;
+	findDistance = 0;
 }
 
 /*
@@ -83,11 +87,14 @@ HashIndex::Init
 */
 void HashIndex::Init( void ) {
 	OG_ASSERT( hashSize > 0 && MathIsPowerOfTwo( hashSize ) );
-	nodeList = new HashIndexNode_s *[hashSize];
-	memset(nodeList, 0, sizeof(HashIndexNode_s *) * hashSize);
+	mask = hashSize-1;
+	slots = new HashIndexSlot_s[hashSize];
+	for( int i=0; i<hashSize; i++ )
+		slots[i].index = -1;
+	numEntries = 0;
 	initialized = true;
 
-	findNode=NULL;
+	findSlot = -1;
 }
 
 /*
@@ -97,28 +104,88 @@ HashIndex::Clear
 */
 void HashIndex::Clear( int newHashSize ) {
 	if ( initialized ) {
-		HashIndexNode_s *node;
-		HashIndexNode_s *nextNode;
-		for( int i=0; i<hashSize; i++ ) {
-			if ( nodeList[i] ) {
-				node = nodeList[i];
-				while ( node ) {
-					nextNode = node->next;
-					delete node;
-					node = nextNode;
-				}
-			}
-		}
-		delete[] nodeList;
-		nodeList = NULL;
-		allnodes.Clear();
-		findNode = NULL;
+		delete[] slots;
+		slots = NULL;
+		numEntries = 0;
+		findSlot = -1;
 
 		initialized = false;
 	}
 	if ( newHashSize != -1 ) {
 		OG_ASSERT( newHashSize > 0 && MathIsPowerOfTwo( newHashSize ) );
 		hashSize = newHashSize;
+		mask = hashSize-1;
+	}
+}
+
+/*
+================
+HashIndex::Grow
+================
+*/
+void HashIndex::Grow( void ) {
+	HashIndexSlot_s *oldSlots = slots;
+	int oldSize = hashSize;
+
+	hashSize *= 2;
+	Init();
+	for( int i=0; i<oldSize; i++ ) {
+		if ( oldSlots[i].index != -1 ) {
+			Insert( oldSlots[i].hash, oldSlots[i].index );
+			numEntries++;
+		}
+	}
+	delete[] oldSlots;
+}
+
+/*
+================
+HashIndex::Insert
+================
+*/
+void HashIndex::Insert( int hash, int index ) {
+	HashIndexSlot_s entry;
+	entry.hash = hash;
+	entry.index = index;
+
+	int slot = hash & mask;
+	int distance = 0;
+	for(;;) {
+		HashIndexSlot_s &current = slots[slot];
+		if ( current.index == -1 ) {
+			current = entry;
+			return;
+		}
+		// take the slot from entries that are closer to their home, so no probe gets long
+		int currentDistance = ProbeDistance( slot, current.hash );
+		if ( currentDistance < distance ) {
+			HashIndexSlot_s temp = current;
+			current = entry;
+			entry = temp;
+			distance = currentDistance;
+		}
+		slot = (slot + 1) & mask;
+		distance++;
+	}
+}
+
+/*
+================
+HashIndex::FindSlot
+================
+*/
+int HashIndex::FindSlot( int hash, int index ) const {
+	if ( !initialized )
+		return -1;
+
+	int slot = hash & mask;
+	for( int distance=0; ; distance++ ) {
+		const HashIndexSlot_s &current = slots[slot];
+		if ( current.index == -1 || ProbeDistance( slot, current.hash ) < distance )
+			return -1;
+		if ( current.hash == hash && current.index == index )
+			return slot;
+		slot = (slot + 1) & mask;
 	}
 }
 
@@ -130,27 +197,13 @@ HashIndex::Add
 void HashIndex::Add( int hash, int index ) {
 	if ( !initialized )
 		Init();
+	else if ( FindSlot( hash, index ) != -1 )
+		return;
 
-	int nodeIndex = (hash & mask);
-	HashIndexNode_s *node = nodeList[nodeIndex];
-	if ( node ) {
-		while ( node->next ) {
-			if ( node->index == index )
-				return;
-			node = node->next;
-		}
-		if ( node->index == index )
-			return;
-
-		node->next = new HashIndexNode_s;
-		node = node->next;
-	}
-	else {
-		node = nodeList[nodeIndex] = new HashIndexNode_s;
-	}
-	node->next = NULL;
-	node->index = index;
-	allnodes.Append(node);
+	if ( (numEntries + 1) * HASH_MAX_LOAD_DEN > hashSize * HASH_MAX_LOAD_NUM )
+		Grow();
+	Insert( hash, index );
+	numEntries++;
 }
 
 /*
@@ -158,38 +211,42 @@ void HashIndex::Add( int hash, int index ) {
 HashIndex::Remove
 ================
 */
-void HashIndex::Remove( int hash, int index ) {
-	if ( !initialized )
+void HashIndex::Remove( int hash, int index, bool shiftIndices ) {
+	int slot = FindSlot( hash, index );
+	OG_ASSERT( slot != -1 ); // this must exist
+	if ( slot == -1 )
 		return;
 
-	int nodeIndex = (hash & mask);
-	HashIndexNode_s *lastNode = NULL;
-	HashIndexNode_s *node = nodeList[nodeIndex];
-
-	OG_ASSERT(node); // this must exist
-	while ( node ) {
-		if ( node->index == index ) {
-			if ( lastNode )
-				lastNode->next = node->next;
-			else
-				nodeList[nodeIndex] = node->next;
-
-			int i = allnodes.Find(node);
-			allnodes.Remove(i);
-
-			// decrease all nodes indices that are above the deleted nodes index
-			int num = allnodes.Num();
-			for( int i=0; i<num; i++ ) {
-				if ( allnodes[i]->index > index )
-					allnodes[i]->index--;
-			}
-
-			delete node;
-			return;
+	// shift the following entries back, until one is at its home or the slot is empty
+	int next = (slot + 1) & mask;
+	while( slots[next].index != -1 && ProbeDistance( next, slots[next].hash ) > 0 ) {
+		slots[slot] = slots[next];
+		slot = next;
+		next = (next + 1) & mask;
+	}
+	slots[slot].index = -1;
+	numEntries--;
+	findSlot = -1;
+
+	if ( shiftIndices ) {
+		// decrease all indices that are above the removed index
+		for( int i=0; i<hashSize; i++ ) {
+			if ( slots[i].index > index )
+				slots[i].index--;
 		}
-		lastNode = node;
-		node = node->next;
 	}
 }
 
+/*
+================
+HashIndex::Reindex
+================
+*/
+void HashIndex::Reindex( int hash, int oldIndex, int newIndex ) {
+	int slot = FindSlot( hash, oldIndex );
+	OG_ASSERT( slot != -1 ); // this must exist
+	if ( slot != -1 )
+		slots[slot].index = newIndex;
+}
+
 }
@@ -29,6 +29,7 @@ freely, subject to the following restrictions:
 */
 
 #include <og/Common.h>
+#include <og/Common/Thread/Thread.h>
 
 namespace og {
 
@@ -55,19 +56,19 @@ void StringPool::Clear( void ) {
 StringPool::Alloc
 ================
 */
-const PoolString *StringPool::Alloc( const char *value ) {
+const PoolString *StringPool::Alloc( const StringView &value ) {
 	int hash = hashIndex.GenerateKey( value, caseSensitive );
 	if ( caseSensitive ) {
 		for ( int i=hashIndex.First( hash ); i!=-1; i=hashIndex.Next() ) {
 			if ( strings[i].Cmp( value ) == 0 ) {
-				strings[i].inUse++;
+				strings[i].inUse.Increment();
 				return &strings[i];
 			}
 		}
 	} else {
 		for ( int i=hashIndex.First( hash ); i!=-1; i=hashIndex.Next() ) {
 			if ( strings[i].Icmp( value ) == 0 ) {
-				strings[i].inUse++;
+				strings[i].inUse.Increment();
 				return &strings[i];
 			}
 		}
@@ -75,7 +76,7 @@ const PoolString *StringPool::Alloc( const char *value ) {
 
 	hashIndex.Add( hash, strings.Num() );
 	PoolString &poolStr = strings.Alloc();
-	poolStr.Init( this, value );
+	poolStr.Init( this, value, caseSensitive ? HashIndex::GenerateKey( value, false ) : hash );
 	return &poolStr;
 }
 
@@ -85,11 +86,10 @@ StringPool::Free
 ================
 */
 void StringPool::Free( const PoolString *poolStr ) {
-	OG_ASSERT( poolStr->inUse >= 1 );
+	OG_ASSERT( poolStr->inUse.Get() >= 1 );
 	OG_ASSERT( poolStr->pool == this );
 
-	poolStr->inUse--;
-	if ( poolStr->inUse <= 0 ) {
+	if ( poolStr->inUse.Decrement() <= 0 ) {
 		int hash = hashIndex.GenerateKey( poolStr->c_str(), caseSensitive );
 		int i;
 		if ( caseSensitive ) {
@@ -117,13 +117,203 @@ StringPool::Copy
 ================
 */
 const PoolString *StringPool::Copy( const PoolString *poolStr ) {
-	OG_ASSERT( poolStr->inUse >= 1 );
+	OG_ASSERT( poolStr->inUse.Get() >= 1 );
 
 	if ( poolStr->pool != this )
-		return Alloc( poolStr->c_str() );
+		return Alloc( *poolStr );
 
-	poolStr->inUse++;
+	poolStr->inUse.Increment();
 	return poolStr;
 }
 
+/*
+==============================================================================
+
+  SharedStringPool
+
+==============================================================================
+*/
+struct SharedStringPool::Stripe {
+	ogst::mutex	mutex;
+	StringPool	pool;
+	char		pad[OG_CACHE_LINE_SIZE];	// keep the locks of neighbour stripes off the same cache line
+};
+
+/*
+================
+SharedStringPool::SharedStringPool
+================
+*/
+SharedStringPool::SharedStringPool( bool _caseSensitive ) {
+	caseSensitive = _caseSensitive;
+	stripes = new Stripe[NUM_STRIPES];
+	for( int i=0; i<NUM_STRIPES; i++ )
+		stripes[i].pool.SetCaseSensitive( caseSensitive );
+}
+
+/*
+================
+SharedStringPool::~SharedStringPool
+================
+*/
+SharedStringPool::~SharedStringPool() {
+	delete[] stripes;
+}
+
+/*
+================
+SharedStringPool::GetStripe
+================
+*/
+SharedStringPool::Stripe &SharedStringPool::GetStripe( const StringView &value ) const {
+	// use the top bits, the pool of the stripe uses the low ones
+	uInt hash = static_cast<uInt>( HashIndex::GenerateKey( value, caseSensitive ) );
+	return stripes[hash >> (32 - STRIPE_BITS)];
+}
+
+/*
+================
+SharedStringPool::IsOwner
+================
+*/
+bool SharedStringPool::IsOwner( const PoolString *poolStr ) const {
+	for( int i=0; i<NUM_STRIPES; i++ ) {
+		if ( poolStr->pool == &stripes[i].pool )
+			return true;
+	}
+	return false;
+}
+
+/*
+================
+SharedStringPool::Num
+================
+*/
+int SharedStringPool::Num( void ) const {
+	int num = 0;
+	for( int i=0; i<NUM_STRIPES; i++ ) {
+		ogst::unique_lock<ogst::mutex> lock( stripes[i].mutex );
+		num += stripes[i].pool.Num();
+	}
+	return num;
+}
+
+/*
+================
+SharedStringPool::Alloc
+================
+*/
+const PoolString *SharedStringPool::Alloc( const StringView &value ) {
+	Stripe &stripe = GetStripe( value );
+	ogst::unique_lock<ogst::mutex> lock( stripe.mutex );
+	return stripe.pool.Alloc( value );
+}
+
+/*
+================
+SharedStringPool::Free
+================
+*/
+void SharedStringPool::Free( const PoolString *poolStr ) {
+	OG_ASSERT( IsOwner( poolStr ) );
+
+	// Drop a reference without locking, as long as it's not the last one.
+	// Alloc only increases the count under the lock, so it can't revive a string we are about to destroy.
+	int count = poolStr->inUse.Get();
+	while( count > 1 ) {
+		int prev = poolStr->inUse.CompareExchange( count - 1, count );
+		if ( prev == count )
+			return;
+		count = prev;
+	}
+
+	Stripe &stripe = GetStripe( *poolStr );
+	ogst::unique_lock<ogst::mutex> lock( stripe.mutex );
+	stripe.pool.Free( poolStr );
+}
+
+/*
+================
+SharedStringPool::Copy
+================
+*/
+const PoolString *SharedStringPool::Copy( const PoolString *poolStr ) {
+	OG_ASSERT( poolStr->inUse.Get() >= 1 );
+
+	if ( !IsOwner( poolStr ) )
+		return Alloc( *poolStr );
+
+	// the caller holds a reference, so the string can't be destroyed meanwhile
+	poolStr->inUse.Increment();
+	return poolStr;
+}
+
+/*
+==============================================================================
+
+  Name
+
+==============================================================================
+*/
+
+// Create the pool before main, so the first Name can't be created by two threads at once
+static SharedStringPool *namePool = &Name::GetPool();
+
+/*
+================
+Name::GetPool
+================
+*/
+SharedStringPool &Name::GetPool( void ) {
+	// never deleted, Names in static objects may get destroyed after this file
+	static SharedStringPool *pool = new SharedStringPool;
+	return *pool;
+}
+
+/*
+================
+Name::Name
+================
+*/
+Name::Name( const char *value ) {
+	str = ( value == NULL || value[0] == '\0' ) ? NULL : GetPool().Alloc( value );
+}
+Name::Name( const Name &other ) {
+	str = other.str ? GetPool().Copy( other.str ) : NULL;
+}
+
+/*
+================
+Name::~Name
+================
+*/
+Name::~Name() {
+	if ( str )
+		GetPool().Free( str );
+}
+
+/*
+================
+Name::GetHash
+================
+*/
+int Name::GetHash( void ) const {
+	return str ? str->GetHash() : HashIndex::GenerateKey( "", false );
+}
+
+/*
+================
+Name::operator=
+================
+*/
+Name &Name::operator=( const Name &other ) {
+	if ( str != other.str ) {
+		const PoolString *old = str;
+		str = other.str ? GetPool().Copy( other.str ) : NULL;
+		if ( old )
+			GetPool().Free( old );
+	}
+	return *this;
+}
+
 }
@@ -0,0 +1,184 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Event queue batches
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include <og/Common/Thread/EventQueue.h>
+#include <og/Common/Thread/Thread.h>
+
+namespace og {
+
+/*
+==============================================================================
+
+  EventBatchList
+
+==============================================================================
+*/
+class EventBatchList {
+public:
+	EventBatchList() : first(NULL) {}
+
+	// Called when the thread ends, batches that have not been flushed are lost
+	~EventBatchList() {
+		while( first ) {
+			EventBatch *next = first->nextOpen;
+			delete first;
+			first = next;
+		}
+	}
+
+	EventBatch *Find( const void *queue ) const {
+		for( EventBatch *batch = first; batch != NULL; batch = batch->nextOpen ) {
+			if ( batch->queue == queue )
+				return batch;
+		}
+		return NULL;
+	}
+
+	EventBatch *first;
+};
+static TLS<EventBatchList> openBatches;
+
+/*
+==============================================================================
+
+  EventBatch
+
+==============================================================================
+*/
+/*
+================
+EventBatch::~EventBatch
+================
+*/
+EventBatch::~EventBatch() {
+	int num = events.Num();
+	for( int i=0; i<num; i++ )
+		delete events[i].evt;
+}
+
+/*
+================
+EventBatch::Execute
+================
+*/
+void EventBatch::Execute( void ) {
+	int num = events.Num();
+	for( int i=0; i<num; i++ ) {
+		events[i].evt->Execute();
+		delete events[i].evt;
+	}
+	events.Clear();
+}
+
+/*
+================
+EventBatch::Begin
+================
+*/
+void EventBatch::Begin( const void *queue ) {
+	EventBatchList *list = openBatches.Get();
+	EventBatch *batch = list->Find( queue );
+	if ( batch != NULL ) {
+		batch->depth++;
+		return;
+	}
+	batch = new EventBatch( queue );
+	batch->nextOpen = list->first;
+	list->first = batch;
+}
+
+/*
+================
+EventBatch::End
+================
+*/
+EventBatch *EventBatch::End( const void *queue ) {
+	EventBatchList *list = openBatches.Get();
+	EventBatch **link = &list->first;
+	while( *link != NULL && (*link)->queue != queue )
+		link = &(*link)->nextOpen;
+
+	EventBatch *batch = *link;
+	OG_ASSERT( batch != NULL );
+	if ( batch == NULL || --batch->depth > 0 )
+		return NULL;
+
+	*link = batch->nextOpen;
+	batch->nextOpen = NULL;
+	if ( batch->events.IsEmpty() ) {
+		delete batch;
+		return NULL;
+	}
+	return batch;
+}
+
+/*
+================
+EventBatch::Append
+================
+*/
+bool EventBatch::Append( const void *queue, QueuedEvent *evt ) {
+	EventBatchList *list = openBatches.Get();
+	if ( list->first == NULL )
+		return false;
+	EventBatch *batch = list->Find( queue );
+	if ( batch == NULL )
+		return false;
+	batch->AppendEvent( evt );
+	return true;
+}
+
+/*
+================
+EventBatch::AppendEvent
+================
+*/
+void EventBatch::AppendEvent( QueuedEvent *evt ) {
+	Entry entry;
+	entry.evt = evt;
+	if ( evt->GetCoalesceKey( entry.object, entry.type ) && entry.object != NULL ) {
+		int hash = static_cast<int>( reinterpret_cast<size_t>( entry.object ) >> 4 ) ^ ( entry.type * 31 );
+		for( int i=keyHash.First( hash ); i != -1; i=keyHash.Next() ) {
+			Entry &other = events[i];
+			if ( other.object == entry.object && other.type == entry.type ) {
+				// keep the position of the first one, so the order to other events stays intact
+				delete other.evt;
+				other.evt = evt;
+				return;
+			}
+		}
+		keyHash.Add( hash, events.Num() );
+	} else {
+		entry.object = NULL;
+		entry.type = 0;
+	}
+	events.Append( entry );
+}
+
+}
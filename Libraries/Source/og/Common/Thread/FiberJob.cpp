@@ -0,0 +1,469 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Jobs running on fibers
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#if defined( __APPLE__ ) && !defined( _XOPEN_SOURCE )
+	#define _XOPEN_SOURCE 600	// ucontext is only declared with this on Mac OS X
+#endif
+
+#include <og/Common/Thread/FiberJob.h>
+
+#if OG_WIN32
+	#include <windows.h>
+#else
+	#include <ucontext.h>
+#endif
+
+namespace og {
+
+const int FIBER_RUNNING		= 0;	// running or waiting in the job queue
+const int FIBER_SUSPENDING	= 1;	// leaving the fiber because of Suspend()
+const int FIBER_SUSPENDED	= 2;	// the worker has let go, Resume() needs to add it again
+const int FIBER_RESUMED		= 3;	// Resume() got called before the worker let go
+
+/*
+==============================================================================
+
+  Fiber
+
+==============================================================================
+*/
+#if OG_WIN32
+struct FiberData {
+	LPVOID		fiber;
+	LPVOID		caller;
+	Fiber::Func	func;
+	void *		param;
+	bool		finished;
+};
+
+// Win32 needs the calling thread to be a fiber as well
+class ThreadFiber {
+public:
+	ThreadFiber() : fiber(NULL) {}
+	~ThreadFiber() {
+		if ( fiber )
+			ConvertFiberToThread();
+	}
+	LPVOID	fiber;
+};
+static TLS<ThreadFiber> threadFiber;
+
+static VOID CALLBACK FiberEntry( LPVOID param ) {
+	FiberData *fd = static_cast<FiberData *>( param );
+	fd->func( fd->param );
+	fd->finished = true;
+
+	// a win32 fiber must never return
+	for(;;)
+		SwitchToFiber( fd->caller );
+}
+
+/*
+================
+Fiber::~Fiber
+================
+*/
+Fiber::~Fiber() {
+	if ( data ) {
+		FiberData *fd = static_cast<FiberData *>( data );
+		DeleteFiber( fd->fiber );
+		delete fd;
+	}
+}
+
+/*
+================
+Fiber::Create
+================
+*/
+bool Fiber::Create( Func func, void *param, int stackSize ) {
+	FiberData *fd = static_cast<FiberData *>( data );
+	if ( fd )
+		DeleteFiber( fd->fiber );
+	else
+		fd = new FiberData;
+	fd->func = func;
+	fd->param = param;
+	fd->finished = false;
+	fd->caller = NULL;
+	fd->fiber = CreateFiber( stackSize, FiberEntry, fd );
+	if ( fd->fiber == NULL ) {
+		delete fd;
+		data = NULL;
+		return false;
+	}
+	data = fd;
+	return true;
+}
+
+/*
+================
+Fiber::Enter
+================
+*/
+void Fiber::Enter( void ) {
+	FiberData *fd = static_cast<FiberData *>( data );
+	OG_ASSERT( fd != NULL && !fd->finished );
+	ThreadFiber *tf = threadFiber.Get();
+	if ( tf->fiber == NULL ) {
+		tf->fiber = ConvertThreadToFiber( NULL );
+		if ( tf->fiber == NULL )
+			tf->fiber = GetCurrentFiber();	// someone else converted it already
+	}
+	fd->caller = GetCurrentFiber();
+	SwitchToFiber( fd->fiber );
+}
+
+/*
+================
+Fiber::Leave
+================
+*/
+void Fiber::Leave( void ) {
+	FiberData *fd = static_cast<FiberData *>( data );
+	SwitchToFiber( fd->caller );
+}
+
+#else
+struct FiberData {
+	ucontext_t	context;
+	ucontext_t	caller;
+	char *		stack;
+	int			stackSize;
+	Fiber::Func	func;
+	void *		param;
+	bool		finished;
+};
+
+// makecontext only passes int arguments, so the pointer gets split in two
+static void FiberEntry( uInt low, uInt high ) {
+	FiberData *fd = reinterpret_cast<FiberData *>( ( static_cast<uLongLong>( high ) << 32 ) | low );
+	fd->func( fd->param );
+	fd->finished = true;
+	// returns to caller through uc_link
+}
+
+/*
+================
+Fiber::~Fiber
+================
+*/
+Fiber::~Fiber() {
+	if ( data ) {
+		FiberData *fd = static_cast<FiberData *>( data );
+		delete[] fd->stack;
+		delete fd;
+	}
+}
+
+// Allocates the data or reuses the old one, so Fiber::Create never changes fd after getcontext
+static FiberData *AllocFiberData( FiberData *fd, int stackSize ) {
+	if ( fd == NULL ) {
+		fd = new FiberData;
+		fd->stack = new char[stackSize];
+	} else if ( fd->stackSize != stackSize ) {
+		delete[] fd->stack;
+		fd->stack = new char[stackSize];
+	}
+	fd->stackSize = stackSize;
+	return fd;
+}
+
+/*
+================
+Fiber::Create
+================
+*/
+bool Fiber::Create( Func func, void *param, int stackSize ) {
+	FiberData *fd = AllocFiberData( static_cast<FiberData *>( data ), stackSize );
+	data = fd;
+	fd->func = func;
+	fd->param = param;
+	fd->finished = false;
+
+	if ( getcontext( &fd->context ) != 0 ) {
+		delete[] fd->stack;
+		delete fd;
+		data = NULL;
+		return false;
+	}
+	fd->context.uc_stack.ss_sp = fd->stack;
+	fd->context.uc_stack.ss_size = stackSize;
+	fd->context.uc_link = &fd->caller;
+	uLongLong ptr = reinterpret_cast<uLongLong>( fd );
+	makecontext( &fd->context, reinterpret_cast<void (*)( void )>( FiberEntry ), 2, static_cast<uInt>( ptr ), static_cast<uInt>( ptr >> 32 ) );
+	return true;
+}
+
+/*
+================
+Fiber::Enter
+================
+*/
+void Fiber::Enter( void ) {
+	FiberData *fd = static_cast<FiberData *>( data );
+	OG_ASSERT( fd != NULL && !fd->finished );
+	swapcontext( &fd->caller, &fd->context );
+}
+
+/*
+================
+Fiber::Leave
+================
+*/
+void Fiber::Leave( void ) {
+	FiberData *fd = static_cast<FiberData *>( data );
+	swapcontext( &fd->context, &fd->caller );
+}
+#endif
+
+/*
+================
+Fiber::IsActive
+================
+*/
+bool Fiber::IsActive( void ) const {
+	return data != NULL && !static_cast<FiberData *>( data )->finished;
+}
+
+/*
+==============================================================================
+
+  FiberJob
+
+==============================================================================
+*/
+/*
+================
+FiberJob::FiberJob
+================
+*/
+FiberJob::FiberJob( JobManager *_manager, int _stackSize ) {
+	manager = _manager;
+	stackSize = _stackSize;
+	result = JOB_DELETE;
+}
+
+/*
+================
+FiberJob::FiberMain
+================
+*/
+void FiberJob::FiberMain( void *param ) {
+	FiberJob *job = static_cast<FiberJob *>( param );
+	job->result = job->Run();
+}
+
+/*
+================
+FiberJob::Execute
+================
+*/
+JobResult FiberJob::Execute( void ) {
+	if ( !fiber.IsActive() ) {
+		if ( !fiber.Create( FiberMain, this, stackSize ) ) {
+			User::Warning( "FiberJob: Could not create a fiber." );
+			return JOB_DELETE;
+		}
+		// the deadline is about the start, a resumed job is not late again
+		SetDeadline( 0 );
+	}
+
+	state.Set( FIBER_RUNNING );
+	fiber.Enter();
+	if ( !fiber.IsActive() )
+		return result;
+
+	// once SUSPENDED is set, Resume() may hand the job to another worker right away
+	if ( state.CompareExchange( FIBER_SUSPENDED, FIBER_SUSPENDING ) != FIBER_SUSPENDING )
+		manager->ResumeJob( this );
+	return JOB_SUSPEND;
+}
+
+/*
+================
+FiberJob::Resume
+================
+*/
+void FiberJob::Resume( void ) {
+	if ( state.Exchange( FIBER_RESUMED ) == FIBER_SUSPENDED )
+		manager->ResumeJob( this );
+}
+
+/*
+================
+FiberJob::Suspend
+================
+*/
+void FiberJob::Suspend( void ) {
+	if ( state.CompareExchange( FIBER_SUSPENDING, FIBER_RUNNING ) != FIBER_RUNNING ) {
+		// Resume() came first
+		state.Set( FIBER_RUNNING );
+		return;
+	}
+	fiber.Leave();
+}
+
+/*
+================
+FiberJob::Reschedule
+================
+*/
+void FiberJob::Reschedule( void ) {
+	state.Set( FIBER_RESUMED );
+	fiber.Leave();
+}
+
+/*
+================
+FiberJob::LoadFile
+================
+*/
+int FiberJob::LoadFile( AsyncFileReader *reader, const char *path, byte **buffer ) {
+	FileReadRequest request;
+	request.job = this;
+	request.path = path;
+	request.buffer = buffer;
+	request.size = -1;
+	if ( !reader->Read( &request ) )
+		return -1;
+	Suspend();
+	return request.size;
+}
+
+/*
+==============================================================================
+
+  AsyncFileReaderThread
+
+==============================================================================
+*/
+class AsyncFileReaderThread : public Thread {
+public:
+	AsyncFileReaderThread( AsyncFileReader *_reader ) : reader(_reader) {}
+
+protected:
+	void Run( void ) {
+		LoadRequestFunc func( reader->fileSystem );
+		while( keepRunning ) {
+			reader->requests.ConsumeAll( func );
+			WaitForWakeUp();
+		}
+		reader->requests.ConsumeAll( func );
+	}
+
+private:
+	class LoadRequestFunc {
+	public:
+		LoadRequestFunc( FileSystemCore *_fileSystem ) : fileSystem(_fileSystem) {}
+		void operator()( FileReadRequest *request ) {
+			request->size = fileSystem->LoadFile( request->path, request->buffer );
+			// the request lives on the fiber stack, so it's gone after this
+			request->job->Resume();
+		}
+		FileSystemCore *fileSystem;
+	};
+
+	AsyncFileReader *reader;
+};
+
+/*
+==============================================================================
+
+  AsyncFileReader
+
+==============================================================================
+*/
+/*
+================
+AsyncFileReader::AsyncFileReader
+================
+*/
+AsyncFileReader::AsyncFileReader() {
+	thread = NULL;
+	fileSystem = NULL;
+}
+
+/*
+================
+AsyncFileReader::~AsyncFileReader
+================
+*/
+AsyncFileReader::~AsyncFileReader() {
+	Stop();
+}
+
+/*
+================
+AsyncFileReader::Start
+================
+*/
+void AsyncFileReader::Start( FileSystemCore *_fileSystem ) {
+	Stop();
+	mutex.lock();
+	fileSystem = _fileSystem;
+	thread = new AsyncFileReaderThread( this );
+	thread->Start( "FileReader" );
+	mutex.unlock();
+}
+
+/*
+================
+AsyncFileReader::Stop
+================
+*/
+void AsyncFileReader::Stop( void ) {
+	mutex.lock();
+	Thread *oldThread = thread;
+	thread = NULL;
+	mutex.unlock();
+
+	// finishes the queued reads before it ends
+	if ( oldThread )
+		oldThread->Stop( true );
+}
+
+/*
+================
+AsyncFileReader::Read
+================
+*/
+bool AsyncFileReader::Read( FileReadRequest *request ) {
+	mutex.lock();
+	if ( thread == NULL ) {
+		mutex.unlock();
+		return false;
+	}
+	requests.Produce( request );
+	thread->WakeUp();
+	mutex.unlock();
+	return true;
+}
+
+}
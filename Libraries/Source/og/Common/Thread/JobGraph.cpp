@@ -0,0 +1,235 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Job Graph ( jobs with dependencies )
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include <og/Common/Thread/JobGraph.h>
+
+namespace og {
+
+/*
+==============================================================================
+
+  JobNode
+
+==============================================================================
+*/
+/*
+================
+JobNode::Execute
+================
+*/
+JobResult JobNode::Execute( void ) {
+	if ( job ) {
+		JobResult result = job->Execute();
+		// Nodes can't be repeated or suspended, the continuations would run too early
+		OG_ASSERT( result == JOB_DONE || result == JOB_DELETE );
+		if ( result == JOB_DELETE )
+			SafeDelete( job );
+	}
+
+	ReleaseContinuations( false );
+
+	// The graph might get destroyed right after this, so don't touch anything afterwards
+	graph->NodeDone();
+	return JOB_DONE;
+}
+
+/*
+================
+JobNode::Cancel
+================
+*/
+JobResult JobNode::Cancel( void ) {
+	if ( job && job->Cancel() == JOB_DELETE )
+		SafeDelete( job );
+
+	ReleaseContinuations( true );
+	graph->NodeDone();
+	return JOB_DONE;
+}
+
+/*
+================
+JobNode::DeadlineMissed
+================
+*/
+void JobNode::DeadlineMissed( uLongLong usecLate ) {
+	if ( job )
+		job->DeadlineMissed( usecLate );
+}
+
+/*
+================
+JobNode::ReleaseContinuations
+================
+*/
+void JobNode::ReleaseContinuations( bool canceled ) {
+	JobNode *next;
+	int num = continuations.Num();
+	for( int i=0; i<num; i++ ) {
+		next = continuations[i];
+		if ( canceled )
+			next->dependencyCanceled = true;
+
+		if ( next->numPending.Decrement() == 0 ) {
+			if ( next->dependencyCanceled )
+				next->Cancel();
+			else
+				graph->manager->AddJob( next );
+		}
+	}
+}
+
+/*
+==============================================================================
+
+  JobGraph
+
+==============================================================================
+*/
+/*
+================
+JobGraph::JobGraph
+================
+*/
+JobGraph::JobGraph( JobManager *mgr ) {
+	manager = mgr;
+	isDone = true;
+}
+
+/*
+================
+JobGraph::~JobGraph
+================
+*/
+JobGraph::~JobGraph() {
+	Wait();
+	Clear();
+}
+
+/*
+================
+JobGraph::AddJob
+================
+*/
+JobNode *JobGraph::AddJob( Job *job ) {
+	OG_ASSERT( IsDone() );
+	JobNode *node = new JobNode( this, job );
+	nodes.Append( node );
+	return node;
+}
+
+/*
+================
+JobGraph::AddDependency
+================
+*/
+void JobGraph::AddDependency( JobNode *first, JobNode *then ) {
+	OG_ASSERT( IsDone() );
+	OG_ASSERT( first->graph == this && then->graph == this && first != then );
+	first->continuations.Append( then );
+	then->numDependencies++;
+}
+
+/*
+================
+JobGraph::Clear
+================
+*/
+void JobGraph::Clear( void ) {
+	OG_ASSERT( IsDone() );
+	int num = nodes.Num();
+	for( int i=0; i<num; i++ )
+		delete nodes[i];
+	nodes.Clear();
+}
+
+/*
+================
+JobGraph::Submit
+================
+*/
+void JobGraph::Submit( void ) {
+	OG_ASSERT( IsDone() );
+	int num = nodes.Num();
+	if ( num == 0 )
+		return;
+
+	// Everything needs to be reset before the first job can possibly finish
+	isDone = false;
+	numRemaining.Set( num );
+	for( int i=0; i<num; i++ ) {
+		nodes[i]->numPending.Set( nodes[i]->numDependencies );
+		nodes[i]->dependencyCanceled = false;
+		if ( nodes[i]->job ) {
+			nodes[i]->SetPriority( nodes[i]->job->GetPriority() );
+			nodes[i]->SetDeadline( nodes[i]->job->GetDeadline() );
+		}
+	}
+	MemoryFence();
+
+	// Once the last root is queued the graph might be done and destroyed, so collect them first
+	List<JobNode *> roots;
+	for( int i=0; i<num; i++ ) {
+		if ( nodes[i]->numDependencies == 0 )
+			roots.Append( nodes[i] );
+	}
+	JobManager *mgr = manager;
+	num = roots.Num();
+	for( int i=0; i<num; i++ )
+		mgr->AddJob( roots[i] );
+}
+
+/*
+================
+JobGraph::Wait
+================
+*/
+void JobGraph::Wait( void ) {
+	doneWaiter.Lock();
+	while( !isDone )
+		doneWaiter.Wait();
+	doneWaiter.Unlock();
+}
+
+/*
+================
+JobGraph::NodeDone
+================
+*/
+void JobGraph::NodeDone( void ) {
+	if ( numRemaining.Decrement() == 0 ) {
+		// Signal while locked, the waiter may destroy the graph as soon as it can get the lock
+		doneWaiter.Lock();
+		isDone = true;
+		doneWaiter.SignalAllLocked();
+		doneWaiter.Unlock();
+	}
+}
+
+}
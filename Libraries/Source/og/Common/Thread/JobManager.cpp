@@ -30,6 +30,22 @@ freely, subject to the following restrictions:
 #include <og/Common/Thread/JobManager.h>
 
 namespace og {
+static TLS<WorkerThread *> currentWorker(NULL);
+
+// Check functor for WaitPolicy::Spin
+class FindJobCheck {
+public:
+	FindJobCheck( WorkerThread *_worker, JobManager *_manager, bool &_keepRunning ) : worker(_worker), manager(_manager), keepRunning(_keepRunning), found(NULL) {}
+	bool operator()( void ) {
+		found = manager->FindJob( worker );
+		return found != NULL || !keepRunning;
+	}
+
+	WorkerThread *	worker;
+	JobManager *	manager;
+	bool &			keepRunning;
+	Job *			found;
+};
 
 /*
 ==============================================================================
@@ -44,25 +60,121 @@ WorkerThread::Run
 ================
 */
 void WorkerThread::Run( void ) {
-	wakeUpEvent.Lock();
+	*currentWorker = this;
+	randomSeed = static_cast<uInt>( GetNativeId() ) * 2654435761u + 1;
+	if ( !manager->AcquireSlot( this ) ) {
+		*currentWorker = NULL;
+		return;
+	}
+	int firstCore = manager->firstWorkerCore;
+	if ( firstCore != -1 ) {
+		const CpuTopology &topology = CpuTopology::Get();
+		// nothing to leave free on a single core
+		if ( topology.GetNumCores() == 1 )
+			firstCore = 0;
+		SetAffinity( topology.GetSpreadCpu( slot->index, firstCore ) );
+	}
+
+	Job *next;
 	while( keepRunning ) {
-		if ( !job )
-			wakeUpEvent.Wait();
-		if ( job ) {
-			switch( job->Execute() ) {
-				case JOB_DONE: break;
-				case JOB_REPEAT:
-					manager->AddJob( job );
-					break;
-				case JOB_DELETE:
-					delete job;
-					break;
+		next = manager->FindJob( this );
+		if ( next == NULL ) {
+			next = Park();
+			if ( next == NULL )
+				continue;
+		}
+		uLongLong deadline = next->GetDeadline();
+		if ( deadline != 0 ) {
+			uLongLong now = SysInfo::GetHiResTime();
+			if ( now > deadline ) {
+				manager->numMissedDeadlines.Increment();
+				next->DeadlineMissed( now - deadline );
 			}
-			job = NULL;
 		}
+		JobResult result = next->Execute();
+		switch( result ) {
+			case JOB_DONE: break;
+			case JOB_REPEAT:
+				// goes to the end of the shared queue, so it can't starve the local one
+				manager->QueueJob( next, false );
+				break;
+			case JOB_DELETE:
+				delete next;
+				break;
+			case JOB_SUSPEND:
+				// the job might already be running on another worker, don't touch it anymore
+				break;
+		}
+		numTaken++;
+		if ( inBackground ) {
+			inBackground = false;
+			manager->numInBackground.Decrement();
+		} else
+			manager->numForeground.Decrement();
+		if ( result != JOB_SUSPEND )
+			manager->JobFinished();
 		manager->WorkerIsDone( this );
 	}
-	wakeUpEvent.Unlock();
+
+	manager->ReleaseSlot( this );
+	*currentWorker = NULL;
+}
+
+/*
+================
+WorkerThread::WakeUp
+================
+*/
+void WorkerThread::WakeUp( void ) {
+	Thread::WakeUp();
+
+	// pairs with the fence of the mutex lock in Park(), so either we see the slot or it sees keepRunning
+	MemoryFence();
+	WorkerSlot *parkSlot = slot;
+	if ( parkSlot )
+		parkSlot->wakeUp.Signal();
+}
+
+/*
+================
+WorkerThread::Park
+================
+*/
+Job *WorkerThread::Park( void ) {
+	FindJobCheck check( this, manager, keepRunning );
+	if ( manager->waitPolicy.Spin( check ) )
+		return check.found;
+
+	slot->idle.Set( 1 );
+	manager->parkedSlots.Produce( slot );
+
+	// A job might have been added before we were visible as parked
+	Job *found = manager->FindJob( this );
+	if ( found ) {
+		// If someone else cleared the flag already, the upcoming signal is harmless
+		slot->idle.CompareExchange( 0, 1 );
+		return found;
+	}
+
+	slot->wakeUp.Lock();
+	while( slot->idle.Get() && keepRunning )
+		slot->wakeUp.Wait();
+	slot->wakeUp.Unlock();
+	slot->idle.CompareExchange( 0, 1 );
+	return NULL;
+}
+
+/*
+================
+WorkerThread::NextRandom
+================
+*/
+uInt WorkerThread::NextRandom( void ) {
+	// xorshift
+	randomSeed ^= randomSeed << 13;
+	randomSeed ^= randomSeed >> 17;
+	randomSeed ^= randomSeed << 5;
+	return randomSeed;
 }
 
 
@@ -79,9 +191,27 @@ void WorkerThread::Run( void ) {
 JobManager::JobManager
 ================
 */
+JobManager::JobManager( bool _workStealing ) {
+	numThreadsWanted.Set( 0 );
+	waitForDone = false;
+	workStealing = _workStealing;
+	backgroundShare = 0;
+	firstWorkerCore = 1;
+	lowPriority = false;
+	for( int i=0; i<MAX_WORKERS; i++ )
+		slots[i] = NULL;
+}
+
+/*
+================
+JobManager::~JobManager
+================
+*/
 JobManager::~JobManager() {
 	SetNumWorkers(0, true);
 	KillAll();
+	for( int i=0; i<MAX_WORKERS; i++ )
+		delete slots[i];
 }
 
 /*
@@ -90,13 +220,45 @@ JobManager::AddJob
 ================
 */
 void JobManager::AddJob( Job *job ) {
-	if ( waitForDone ) {
+	QueueJob( job, true );
+}
+
+/*
+================
+JobManager::QueueJob
+================
+*/
+void JobManager::QueueJob( Job *job, bool allowLocal ) {
+	WorkerThread *worker = allowLocal ? *currentWorker : NULL;
+	if ( worker != NULL && worker->manager != this )
+		worker = NULL;
+
+	// Jobs spawned by running jobs are part of what WaitForDone waits for
+	if ( waitForDone && worker == NULL ) {
 		if ( job->Cancel() == JOB_DELETE )
 			delete job;
-	} else {
-		jobList.Produce( job );
-		TriggerNextJob();
+		return;
 	}
+	numPendingJobs.Increment();
+	JobPriority priority = job->GetPriority();
+	if ( priority != JOB_PRIORITY_BACKGROUND )
+		numForeground.Increment();
+	if ( priority != JOB_PRIORITY_NORMAL || !workStealing || worker == NULL || worker->slot == NULL || !worker->slot->queue.Push( job ) )
+		jobLists[priority].Produce( job );
+	WakeIdleWorker();
+}
+
+/*
+================
+JobManager::ResumeJob
+================
+*/
+void JobManager::ResumeJob( Job *job ) {
+	JobPriority priority = job->GetPriority();
+	if ( priority != JOB_PRIORITY_BACKGROUND )
+		numForeground.Increment();
+	jobLists[priority].Produce( job );
+	WakeIdleWorker();
 }
 
 /*
@@ -106,27 +268,37 @@ JobManager::SetNumWorkers
 */
 void JobManager::SetNumWorkers( int num, bool blocking ) {
 	listMutex.lock();
-	if ( num != numThreadsWanted ) {
+	num = Min( num, static_cast<int>(MAX_WORKERS) );
+
+	// slots are only ever added, so thieves can iterate them without locking
+	while( numSlots.Get() < num ) {
+		int index = numSlots.Get();
+		slots[index] = new WorkerSlot( index );
+		numSlots.Increment();
+	}
+	if ( num != numThreadsWanted.Get() ) {
 		if ( num > allThreads.Num() ) {
-			numThreadsWanted = num;
+			numThreadsWanted.Set( num );
 			while( num > allThreads.Num() ) {
 				WorkerThread *worker = new WorkerThread(this);
+				worker->SetLowPriority( lowPriority );
 				worker->Start("Job Manager");
 				allThreads.Append( worker );
-				AddFreeWorker( worker );
+				numThreads.Set( allThreads.Num() );
 			}
 		} else if ( blocking ) {
-			numThreadsWanted = -1;
+			numThreadsWanted.Set( -1 );
 			for( int i=allThreads.Num()-1; i >= num; i-- ) {
 				listMutex.unlock();
 				allThreads[i]->Stop( true );
 				listMutex.lock();
 				allThreads.Remove(i);
+				numThreads.Set( allThreads.Num() );
 			}
-			numThreadsWanted = num;
+			numThreadsWanted.Set( num );
 		}
 		else
-			numThreadsWanted = num;
+			numThreadsWanted.Set( num );
 	}
 	listMutex.unlock();
 }
@@ -138,20 +310,18 @@ JobManager::WaitForDone
 */
 void JobManager::WaitForDone( void ) {
 	listMutex.lock();
-	if ( allThreads.IsEmpty() )
+	if ( allThreads.IsEmpty() ) {
+		listMutex.unlock();
 		return;
+	}
 	listMutex.unlock();
 
 	// do not allow adding new jobs while waiting for done
 	waitForDone = true;
 	doneWaiter.Lock();
-
-	// create a job and wait for it to be done
-	jobList.Produce( new JobStopWaitDone(this) );
-	TriggerNextJob();
-
-	while( waitForDone )
+	while( numPendingJobs.Get() > 0 )
 		doneWaiter.Wait();
+	waitForDone = false;
 	doneWaiter.Unlock();
 }
 
@@ -162,27 +332,25 @@ JobManager::KillAll
 */
 void JobManager::KillAll( void ) {
 	Job *job;
-	while( (job=jobList.Consume()) != NULL ) {
-		if ( job->Cancel() == JOB_DELETE )
-			delete job;
+	for( int i=0; i<JOB_PRIORITY_COUNT; i++ ) {
+		while( (job=jobLists[i].Consume()) != NULL ) {
+			if ( i != JOB_PRIORITY_BACKGROUND )
+				numForeground.Decrement();
+			if ( job->Cancel() == JOB_DELETE )
+				delete job;
+			JobFinished();
+		}
 	}
-}
 
-/*
-================
-JobManager::TriggerNextJob
-================
-*/
-void JobManager::TriggerNextJob( bool wakeUp ) {
-	WorkerThread *worker = availableThreads.Consume();
-	if ( worker ) {
-		Job *job = jobList.Consume();
-		if( job == NULL )
-			availableThreads.Produce( worker );
-		else {
-			worker->SetJob( job );
-			if ( wakeUp )
-				worker->WakeUp();
+	int num = numSlots.Get();
+	for( int i=0; i<num; i++ ) {
+		while( !slots[i]->queue.IsEmpty() ) {
+			if ( (job=slots[i]->queue.Steal()) != NULL ) {
+				numForeground.Decrement();
+				if ( job->Cancel() == JOB_DELETE )
+					delete job;
+				JobFinished();
+			}
 		}
 	}
 }
@@ -193,26 +361,137 @@ JobManager::WorkerIsDone
 ================
 */
 void JobManager::WorkerIsDone( WorkerThread *worker ) {
+	// called after every job, so only lock when the pool is actually shrinking
+	int wanted = numThreadsWanted.Get();
+	if ( wanted == -1 || wanted >= numThreads.Get() )
+		return;
+
 	listMutex.lock();
-	if ( numThreadsWanted >= allThreads.Num() )
-		AddFreeWorker( worker, false );
-	else if ( numThreadsWanted != -1 ) {
+	wanted = numThreadsWanted.Get();
+	if ( wanted < allThreads.Num() && wanted != -1 ) {
 		worker->Stop( false );
 		int index = allThreads.Find( worker );
-		if ( index )
+		if ( index != -1 ) {
 			allThreads.Remove( index );
+			numThreads.Set( allThreads.Num() );
+		}
 	}
 	listMutex.unlock();
 }
 
 /*
 ================
-JobManager::AddFreeWorker
+JobManager::FindJob
 ================
 */
-void JobManager::AddFreeWorker( WorkerThread *worker, bool wakeUp ) {
-	availableThreads.Produce( worker );
-	TriggerNextJob( wakeUp );
+Job *JobManager::FindJob( WorkerThread *worker ) {
+	Job *job;
+	if ( (job=jobLists[JOB_PRIORITY_CRITICAL].Consume()) != NULL )
+		return job;
+	if ( backgroundShare > 0 && (worker->numTaken % backgroundShare) == 0 && (job=FindBackgroundJob( worker )) != NULL )
+		return job;
+	if ( worker->slot && (job=worker->slot->queue.Pop()) != NULL )
+		return job;
+	if ( (job=jobLists[JOB_PRIORITY_NORMAL].Consume()) != NULL )
+		return job;
+
+	int num = workStealing ? numSlots.Get() : 0;
+	if ( num > 1 ) {
+		int start = static_cast<int>( worker->NextRandom() % static_cast<uInt>(num) );
+		for( int i=0; i<num; i++ ) {
+			WorkerSlot *victim = slots[(start + i) % num];
+			if ( victim == worker->slot )
+				continue;
+			while( !victim->queue.IsEmpty() ) {
+				if ( (job=victim->queue.Steal()) != NULL )
+					return job;
+			}
+		}
+	}
+	return FindBackgroundJob( worker );
+}
+
+/*
+================
+JobManager::FindBackgroundJob
+================
+*/
+Job *JobManager::FindBackgroundJob( WorkerThread *worker ) {
+	// leave one worker for critical and normal jobs, as long as there are any
+	int maxInBackground = Max( GetNumWorkers() - 1, 1 );
+	if ( numInBackground.Increment() > maxInBackground && numForeground.Get() > 0 ) {
+		numInBackground.Decrement();
+		return NULL;
+	}
+	Job *job = jobLists[JOB_PRIORITY_BACKGROUND].Consume();
+	if ( job == NULL )
+		numInBackground.Decrement();
+	else
+		worker->inBackground = true;
+	return job;
+}
+
+/*
+================
+JobManager::WakeIdleWorker
+================
+*/
+void JobManager::WakeIdleWorker( void ) {
+	WorkerSlot *slot;
+	while( (slot=parkedSlots.Consume()) != NULL ) {
+		// stale entries belong to workers that found a job while parking
+		if ( slot->idle.CompareExchange( 0, 1 ) == 1 ) {
+			slot->wakeUp.Signal();
+			return;
+		}
+	}
+}
+
+/*
+================
+JobManager::JobFinished
+================
+*/
+void JobManager::JobFinished( void ) {
+	if ( numPendingJobs.Decrement() == 0 )
+		doneWaiter.Signal();
+}
+
+/*
+================
+JobManager::AcquireSlot
+================
+*/
+bool JobManager::AcquireSlot( WorkerThread *worker ) {
+	// a stopped worker might still hold its slot for a moment
+	while( worker->keepRunning ) {
+		int num = numSlots.Get();
+		for( int i=0; i<num; i++ ) {
+			if ( slots[i]->inUse.CompareExchange( 1, 0 ) == 0 ) {
+				worker->slot = slots[i];
+				return true;
+			}
+		}
+		Sleep( 0 );
+	}
+	return false;
+}
+
+/*
+================
+JobManager::ReleaseSlot
+================
+*/
+void JobManager::ReleaseSlot( WorkerThread *worker ) {
+	WorkerSlot *slot = worker->slot;
+	worker->slot = NULL;
+
+	// remaining jobs will be stolen by the other workers or taken by the next owner
+	bool hasJobs = !slot->queue.IsEmpty();
+	slot->idle.Set( 0 );
+	slot->inUse.Set( 0 );
+	if ( hasJobs )
+		WakeIdleWorker();
 }
 
 }
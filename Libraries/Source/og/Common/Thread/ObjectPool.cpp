@@ -0,0 +1,219 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Thread aware pool for small objects
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include <og/Common/Thread/ObjectPool.h>
+#include <og/Common/Thread/Thread.h>
+#include <og/Common/Thread/ThreadLocalStorage.h>
+
+namespace og {
+
+const int NUM_SIZE_CLASSES	= ObjectPool::MAX_SIZE / ObjectPool::GRANULARITY;
+const int POOL_BATCH_SIZE	= 32;					// blocks exchanged between a cache and the shared pool at once
+const int POOL_MAX_CACHED	= POOL_BATCH_SIZE * 2;	// cached blocks per size class and thread
+
+struct FreeBlock {
+	FreeBlock *next;
+};
+
+/*
+==============================================================================
+
+  SharedPool
+
+==============================================================================
+*/
+class SharedPool {
+public:
+	SharedPool() {
+		for( int i=0; i<NUM_SIZE_CLASSES; i++ )
+			freeBlocks[i] = NULL;
+	}
+
+	// Get up to POOL_BATCH_SIZE blocks, allocates a new chunk if there are none
+	FreeBlock *	TakeBatch( int sizeClass, int &count );
+
+	// Return a list of blocks
+	void		GiveBatch( int sizeClass, FreeBlock *first, FreeBlock *last );
+
+private:
+	ogst::mutex	mutex;
+	FreeBlock *	freeBlocks[NUM_SIZE_CLASSES];
+};
+static SharedPool sharedPool;
+
+/*
+================
+SharedPool::TakeBatch
+================
+*/
+FreeBlock *SharedPool::TakeBatch( int sizeClass, int &count ) {
+	mutex.lock();
+	FreeBlock *first = freeBlocks[sizeClass];
+	if ( first ) {
+		FreeBlock *last = first;
+		count = 1;
+		while( count < POOL_BATCH_SIZE && last->next ) {
+			last = last->next;
+			count++;
+		}
+		freeBlocks[sizeClass] = last->next;
+		last->next = NULL;
+		mutex.unlock();
+		return first;
+	}
+	mutex.unlock();
+
+	// Nothing left, split a new chunk into blocks
+	size_t blockSize = (sizeClass + 1) * ObjectPool::GRANULARITY;
+	char *chunk = new char[blockSize * POOL_BATCH_SIZE];
+	for( int i=0; i<POOL_BATCH_SIZE-1; i++ )
+		reinterpret_cast<FreeBlock *>( chunk + i * blockSize )->next = reinterpret_cast<FreeBlock *>( chunk + (i+1) * blockSize );
+	reinterpret_cast<FreeBlock *>( chunk + (POOL_BATCH_SIZE-1) * blockSize )->next = NULL;
+	count = POOL_BATCH_SIZE;
+	return reinterpret_cast<FreeBlock *>( chunk );
+}
+
+/*
+================
+SharedPool::GiveBatch
+================
+*/
+void SharedPool::GiveBatch( int sizeClass, FreeBlock *first, FreeBlock *last ) {
+	mutex.lock();
+	last->next = freeBlocks[sizeClass];
+	freeBlocks[sizeClass] = first;
+	mutex.unlock();
+}
+
+/*
+==============================================================================
+
+  PoolCache
+
+==============================================================================
+*/
+class PoolCache {
+public:
+	PoolCache() {
+		for( int i=0; i<NUM_SIZE_CLASSES; i++ ) {
+			freeBlocks[i] = NULL;
+			numFree[i] = 0;
+		}
+	}
+
+	// Called when the thread ends
+	~PoolCache() {
+		for( int i=0; i<NUM_SIZE_CLASSES; i++ ) {
+			if ( freeBlocks[i] )
+				sharedPool.GiveBatch( i, freeBlocks[i], FindLast( freeBlocks[i] ) );
+		}
+	}
+
+	static FreeBlock *FindLast( FreeBlock *block ) {
+		while( block->next )
+			block = block->next;
+		return block;
+	}
+
+	FreeBlock *	freeBlocks[NUM_SIZE_CLASSES];
+	int			numFree[NUM_SIZE_CLASSES];
+};
+static TLS<PoolCache> poolCache;
+
+/*
+==============================================================================
+
+  ObjectPool
+
+==============================================================================
+*/
+/*
+================
+ObjectPool::Alloc
+================
+*/
+void *ObjectPool::Alloc( size_t size ) {
+	if ( size > MAX_SIZE )
+		return ::operator new( size );
+
+	int sizeClass = size == 0 ? 0 : static_cast<int>( (size - 1) / GRANULARITY );
+	PoolCache *cache = poolCache.Get();
+	if ( cache == NULL ) {
+		int count;
+		FreeBlock *block = sharedPool.TakeBatch( sizeClass, count );
+		if ( block->next )
+			sharedPool.GiveBatch( sizeClass, block->next, PoolCache::FindLast( block->next ) );
+		return block;
+	}
+
+	FreeBlock *block = cache->freeBlocks[sizeClass];
+	if ( block == NULL ) {
+		block = sharedPool.TakeBatch( sizeClass, cache->numFree[sizeClass] );
+		OG_ASSERT( block != NULL );
+	}
+	cache->freeBlocks[sizeClass] = block->next;
+	cache->numFree[sizeClass]--;
+	return block;
+}
+
+/*
+================
+ObjectPool::Free
+================
+*/
+void ObjectPool::Free( void *ptr, size_t size ) {
+	if ( ptr == NULL )
+		return;
+	if ( size > MAX_SIZE ) {
+		::operator delete( ptr );
+		return;
+	}
+
+	int sizeClass = size == 0 ? 0 : static_cast<int>( (size - 1) / GRANULARITY );
+	FreeBlock *block = static_cast<FreeBlock *>( ptr );
+	PoolCache *cache = poolCache.Get();
+	if ( cache == NULL ) {
+		sharedPool.GiveBatch( sizeClass, block, block );
+		return;
+	}
+
+	block->next = cache->freeBlocks[sizeClass];
+	cache->freeBlocks[sizeClass] = block;
+	if ( ++cache->numFree[sizeClass] > POOL_MAX_CACHED ) {
+		// hand the older half back, so other threads can use it
+		FreeBlock *last = block;
+		for( int i=1; i<POOL_BATCH_SIZE; i++ )
+			last = last->next;
+		sharedPool.GiveBatch( sizeClass, last->next, PoolCache::FindLast( last->next ) );
+		last->next = NULL;
+		cache->numFree[sizeClass] = POOL_BATCH_SIZE;
+	}
+}
+
+}
@@ -0,0 +1,145 @@
+/*
+===========================================================================
+The Open Game Libraries.
+Copyright (C) 2007-2010 Lusito Software
+
+Author:  Santo Pfingsten (TTK-Bandit)
+Purpose: Parallel For / Reduce
+-----------------------------------------
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source distribution.
+===========================================================================
+*/
+
+#include <og/Common/Thread/ParallelFor.h>
+
+namespace og {
+
+const int CHUNKS_PER_THREAD = 4;	// a few more chunks than threads, so uneven chunks balance out
+
+/*
+==============================================================================
+
+  ParallelTaskJob
+
+==============================================================================
+*/
+class ParallelTaskJob : public Job {
+public:
+	ParallelTaskJob( ParallelTask *_task ) : task(_task) {}
+
+	JobResult	Execute( void ) {
+		task->RunChunks();
+		task->Release();
+		return JOB_DELETE;
+	}
+
+	JobResult	Cancel( void ) {
+		// the calling thread will do the chunks instead
+		task->Release();
+		return JOB_DELETE;
+	}
+
+private:
+	ParallelTask *task;
+};
+
+/*
+==============================================================================
+
+  ParallelTask
+
+==============================================================================
+*/
+/*
+================
+ParallelTask::ParallelTask
+================
+*/
+ParallelTask::ParallelTask( JobManager *_manager, int _begin, int _end, int _grain ) {
+	manager = _manager;
+	begin = _begin;
+	end = _end;
+	isDone = false;
+
+	int count = end - begin;
+	int numWorkers = manager ? manager->GetNumWorkers() : 0;
+	if ( _grain <= 0 )
+		_grain = count / ( (numWorkers + 1) * CHUNKS_PER_THREAD );
+	grain = Max( _grain, 1 );
+	numChunks = count / grain;
+	if ( numChunks * grain < count )
+		numChunks++;
+	refCount.Set( 1 );
+}
+
+/*
+================
+ParallelTask::Run
+================
+*/
+void ParallelTask::Run( void ) {
+	int numHelpers = manager ? Min( manager->GetNumWorkers(), numChunks - 1 ) : 0;
+	if ( numHelpers > 0 ) {
+		refCount.Add( numHelpers );
+		for( int i=0; i<numHelpers; i++ )
+			manager->AddJob( new ParallelTaskJob( this ) );
+	}
+
+	RunChunks();
+
+	// wait for the chunks the helpers are still working on
+	if ( numDone.Get() < numChunks ) {
+		doneWaiter.Lock();
+		while( !isDone )
+			doneWaiter.Wait();
+		doneWaiter.Unlock();
+	}
+}
+
+/*
+================
+ParallelTask::RunChunks
+================
+*/
+void ParallelTask::RunChunks( void ) {
+	int chunk, from;
+	while( (chunk = nextChunk.Increment() - 1) < numChunks ) {
+		from = begin + chunk * grain;
+		RunChunk( chunk, from, Min( from + grain, end ) );
+		if ( numDone.Increment() == numChunks ) {
+			doneWaiter.Lock();
+			isDone = true;
+			doneWaiter.SignalAllLocked();
+			doneWaiter.Unlock();
+		}
+	}
+}
+
+/*
+================
+ParallelTask::Release
+================
+*/
+void ParallelTask::Release( void ) {
+	if ( refCount.Decrement() == 0 )
+		delete this;
+}
+
+}
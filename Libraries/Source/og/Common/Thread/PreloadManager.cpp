@@ -42,22 +42,18 @@ class PreloadJob : public Job {
 public:
 	PreloadJob( PreloadManager *mgr, PreloadTask *tsk )
 		:manager(mgr), task(tsk) {
+		SetPriority( JOB_PRIORITY_BACKGROUND );
 	}
 	JobResult	Execute( void ) {
-		manager->condition.Lock();
-		if ( manager->preloaded.Num() >= manager->maxPreload )
-			manager->condition.Wait();
-		manager->condition.Unlock();
-
+		task->startTime = SysInfo::GetHiResTime();
 		task->isLoaded = task->Preload();
-
-		manager->condition.Lock();
-		manager->preloaded.Push( task );
-		manager->condition.Unlock();
+		task->endTime = SysInfo::GetHiResTime();
+		manager->TaskPreloaded( task );
 		return JOB_DELETE;
 	}
 	JobResult	Cancel( void ) {
-		OG_ASSERT( false );
+		// Only happens on PreloadManager::Stop
+		delete task;
 		return JOB_DELETE;
 	}
 
@@ -80,10 +76,26 @@ PreloadManager::PreloadManager
 ================
 */
 PreloadManager::PreloadManager() {
-	progress = 0.0f;
 	maxPreload = 1;
-	numProcessed = 0;
-	numTotal = 0;
+	numInFlight = 0;
+	nextSequence = 0;
+	ordered = false;
+	nextSync = 0;
+	recordTimings = false;
+
+	// loading mostly waits for the disk, leave the cores to the frame workers
+	// and let the os prefer them whenever they have work
+	manager.SetWorkerCores( -1 );
+	manager.SetLowPriority( true );
+}
+
+/*
+================
+PreloadManager::~PreloadManager
+================
+*/
+PreloadManager::~PreloadManager() {
+	Stop();
 }
 
 /*
@@ -91,9 +103,16 @@ PreloadManager::PreloadManager() {
 PreloadManager::Start
 ================
 */
-void PreloadManager::Start( int max ) {
+void PreloadManager::Start( int max, bool _ordered ) {
 	manager.SetNumWorkers(1);
+
+	List<PreloadTask *> ready;
+	mutex.lock();
 	maxPreload = Max( max, 1 );
+	ordered = _ordered;
+	TakeReadyTasks( ready );
+	mutex.unlock();
+	StartTasks( ready );
 }
 
 /*
@@ -104,7 +123,24 @@ PreloadManager::Stop
 void PreloadManager::Stop( void ) {
 	manager.KillAll();
 	manager.SetNumWorkers(0, true);
-	ResetProgress();
+
+	mutex.lock();
+	while( !pending.IsEmpty() ) {
+		delete pending.Front();
+		pending.Pop();
+	}
+	PreloadTask *task;
+	while( (task=preloaded.Consume()) != NULL )
+		delete task;
+	for( int i=0; i<reorder.Num(); i++ )
+		delete reorder[i];
+	reorder.Clear();
+	numInFlight = 0;
+	nextSequence = 0;
+	nextSync = 0;
+	numProcessed.Set( 0 );
+	numTotal.Set( 0 );
+	mutex.unlock();
 }
 
 /*
@@ -122,8 +158,15 @@ PreloadManager::AddTask
 ================
 */
 void PreloadManager::AddTask( PreloadTask *task ) {
-	numTotal++;
-	manager.AddJob( new PreloadJob(this, task) );
+	List<PreloadTask *> ready;
+	task->addTime = SysInfo::GetHiResTime();
+	mutex.lock();
+	task->sequence = nextSequence++;
+	numTotal.Increment();
+	pending.Push( task );
+	TakeReadyTasks( ready );
+	mutex.unlock();
+	StartTasks( ready );
 }
 
 /*
@@ -131,26 +174,54 @@ void PreloadManager::AddTask( PreloadTask *task ) {
 PreloadManager::Synchronize
 ================
 */
-float PreloadManager::Synchronize( void ) {
-	condition.Lock();
+float PreloadManager::Synchronize( uLongLong usecBudget ) {
+	uLongLong start = SysInfo::GetHiResTime();
+	uLongLong syncStart, now = start;
 	PreloadTask *task;
-	int num = preloaded.Num();
-	while( !preloaded.IsEmpty() ) {
-		task = preloaded.Front();
+	int num = 0;
+
+	while( (task=NextPreloaded()) != NULL ) {
+		syncStart = now;
 		if ( task->isLoaded )
 			task->Synchronize();
+		now = SysInfo::GetHiResTime();
+
+		if ( recordTimings ) {
+			PreloadTiming &timing = timings.Alloc();
+			timing.name = task->GetName();
+			timing.waitTime = task->GetWaitTime();
+			timing.preloadTime = task->GetPreloadTime();
+			timing.syncTime = now - syncStart;
+		}
 		delete task;
-		preloaded.Pop();
-		numProcessed++;
+		numProcessed.Increment();
+		num++;
+
+		if ( usecBudget && now - start >= usecBudget )
+			break;
 	}
-	if ( numTotal == 0 )
-		progress = 0.0f;
-	else
-		progress = static_cast<float>(numProcessed) / static_cast<float>(numTotal);
-	condition.Unlock();
-	condition.Signal();
-
-	return progress;
+
+	if ( num > 0 ) {
+		List<PreloadTask *> ready;
+		mutex.lock();
+		numInFlight -= num;
+		TakeReadyTasks( ready );
+		mutex.unlock();
+		StartTasks( ready );
+	}
+	return GetProgress();
+}
+
+/*
+================
+PreloadManager::GetProgress
+================
+*/
+float PreloadManager::GetProgress( void ) const {
+	int total = numTotal.Get();
+	if ( total == 0 )
+		return 0.0f;
+	return static_cast<float>( numProcessed.Get() ) / static_cast<float>( total );
 }
 
 /*
@@ -159,10 +230,66 @@ PreloadManager::ResetProgress
 ================
 */
 void PreloadManager::ResetProgress( void ) {
-	// fixme: lock
-	progress = 0.0f;
-	numTotal -= numProcessed;
-	numProcessed = 0;
+	numTotal.Add( -numProcessed.Exchange( 0 ) );
+}
+
+/*
+================
+PreloadManager::TakeReadyTasks
+================
+*/
+void PreloadManager::TakeReadyTasks( List<PreloadTask *> &ready ) {
+	while( numInFlight < maxPreload && !pending.IsEmpty() ) {
+		ready.Append( pending.Front() );
+		pending.Pop();
+		numInFlight++;
+	}
+}
+
+/*
+================
+PreloadManager::StartTasks
+================
+*/
+void PreloadManager::StartTasks( const List<PreloadTask *> &ready ) {
+	int num = ready.Num();
+	for( int i=0; i<num; i++ )
+		manager.AddJob( new PreloadJob( this, ready[i] ) );
+}
+
+/*
+================
+PreloadManager::TaskPreloaded
+================
+*/
+void PreloadManager::TaskPreloaded( PreloadTask *task ) {
+	preloaded.Produce( task );
+}
+
+/*
+================
+PreloadManager::NextPreloaded
+================
+*/
+PreloadTask *PreloadManager::NextPreloaded( void ) {
+	if ( !ordered )
+		return preloaded.Consume();
+
+	// park the ones that finished early, at most maxPreload tasks are in flight
+	PreloadTask *task;
+	while( (task=preloaded.Consume()) != NULL )
+		reorder.Append( task );
+
+	int num = reorder.Num();
+	for( int i=0; i<num; i++ ) {
+		if ( reorder[i]->sequence == nextSync ) {
+			task = reorder[i];
+			reorder.Remove( i );
+			nextSync++;
+			return task;
+		}
+	}
+	return NULL;
 }
 
 }
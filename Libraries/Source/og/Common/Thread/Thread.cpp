@@ -33,6 +33,45 @@ freely, subject to the following restrictions:
 namespace og {
 TLS_Index * lastTlsIndex = NULL;
 
+#ifdef OG_THREAD_LOCAL
+OG_THREAD_LOCAL TLS_Data **	tlsFastSlots = NULL;
+OG_THREAD_LOCAL int			tlsNumFastSlots = 0;
+
+/*
+================
+SetFastSlot
+================
+*/
+static void SetFastSlot( int slot, TLS_Data *data ) {
+	if ( slot >= tlsNumFastSlots ) {
+		if ( data == NULL )
+			return;
+		int num = Max( Max( slot + 1, tlsNumFastSlots * 2 ), 16 );
+		TLS_Data **slots = new TLS_Data *[num];
+		for( int i=0; i<num; i++ )
+			slots[i] = i < tlsNumFastSlots ? tlsFastSlots[i] : NULL;
+		delete[] tlsFastSlots;
+		tlsFastSlots = slots;
+		tlsNumFastSlots = num;
+	}
+	tlsFastSlots[slot] = data;
+}
+#endif
+
+const int WAKEUP_EMPTY		= 0;	// nothing happened
+const int WAKEUP_NOTIFIED	= 1;	// WakeUp() got called
+const int WAKEUP_SLEEPING	= 2;	// the thread is sleeping on wakeUpEvent
+
+// Check functor for WaitPolicy::Spin
+class ConsumeWakeUpCheck {
+public:
+	ConsumeWakeUpCheck( Thread *_thread ) : thread(_thread) {}
+	bool operator()( void ) { return thread->ConsumeWakeUp(); }
+
+private:
+	Thread *thread;
+};
+
 /*
 ================
 TLS_AtExit
@@ -60,6 +99,9 @@ TLS_Data::TLS_Data
 */
 TLS_Data::TLS_Data( const TLS_Index *index ) : previous(NULL), tlsIndex(index) {
 	tlsIndex->SetValue(this);
+#ifdef OG_THREAD_LOCAL
+	SetFastSlot( tlsIndex->GetSlot(), this );
+#endif
 	Register(this);
 }
 
@@ -70,6 +112,9 @@ TLS_Data::~TLS_Data
 */
 TLS_Data::~TLS_Data() {
 	tlsIndex->SetValue(NULL);
+#ifdef OG_THREAD_LOCAL
+	SetFastSlot( tlsIndex->GetSlot(), NULL );
+#endif
 	delete previous;
 }
 
@@ -102,11 +147,144 @@ void TLS_Data::Cleanup( void ) {
 	TLS_Data *lastTLS = static_cast<TLS_Data *>( lastTlsIndex->GetValue() );
 	if ( lastTLS != NULL ) {
 		delete lastTLS;
-#if OG_LINUX
-	#error "SegFault Here - FixMe"
-#endif
 		lastTlsIndex->SetValue( NULL );
 	}
+#ifdef OG_THREAD_LOCAL
+	delete[] tlsFastSlots;
+	tlsFastSlots = NULL;
+	tlsNumFastSlots = 0;
+#endif
+}
+
+/*
+==============================================================================
+
+  CpuTopology
+
+==============================================================================
+*/
+static ogst::mutex topologyMutex;
+static CpuTopology *cpuTopology = NULL;
+
+/*
+================
+CpuTopology::Get
+================
+*/
+const CpuTopology &CpuTopology::Get( void ) {
+	topologyMutex.lock();
+	if ( cpuTopology == NULL )
+		cpuTopology = new CpuTopology;
+	topologyMutex.unlock();
+	return *cpuTopology;
+}
+
+/*
+================
+CpuTopology::CpuTopology
+================
+*/
+CpuTopology::CpuTopology() {
+	numCpus = 0;
+	PlatformProbe();
+
+	// Fall back to one core per cpu
+	if ( numCpus == 0 ) {
+		int num = Max( static_cast<int>( ogst::thread::hardware_concurrency() ), 1 );
+		for( int i=0; i<num; i++ )
+			AddCpu( i, 0, i, 0 );
+	}
+
+	numCores = 0;
+	numNodes = 0;
+	for( int i=0; i<numCpus; i++ ) {
+		if ( i == 0 || cpus[i].node != cpus[i-1].node )
+			numNodes++;
+		if ( i == 0 || cpus[i].node != cpus[i-1].node || cpus[i].package != cpus[i-1].package || cpus[i].coreId != cpus[i-1].coreId )
+			numCores++;
+		cpus[i].core = numCores - 1;
+	}
+}
+
+/*
+================
+CpuTopology::AddCpu
+================
+*/
+void CpuTopology::AddCpu( int id, int package, int coreId, int node ) {
+	if ( numCpus >= MAX_CPUS )
+		return;
+
+	// insertion sort, there are only a few
+	int i = numCpus++;
+	for( ; i > 0; i-- ) {
+		const LogicalCpu &prev = cpus[i-1];
+		if ( prev.node < node || (prev.node == node && (prev.package < package || (prev.package == package
+			&& (prev.coreId < coreId || (prev.coreId == coreId && prev.id < id))))) )
+			break;
+		cpus[i] = prev;
+	}
+	cpus[i].id = id;
+	cpus[i].package = package;
+	cpus[i].coreId = coreId;
+	cpus[i].node = node;
+	cpus[i].core = -1;
+}
+
+/*
+================
+CpuTopology::GetCoreCpu
+================
+*/
+int CpuTopology::GetCoreCpu( int core, int thread ) const {
+	for( int i=0; i<numCpus; i++ ) {
+		if ( cpus[i].core == core ) {
+			if ( i + thread < numCpus && cpus[i + thread].core == core )
+				return cpus[i + thread].id;
+			return -1;
+		}
+	}
+	return -1;
+}
+
+/*
+================
+CpuTopology::GetCoreNode
+================
+*/
+int CpuTopology::GetCoreNode( int core ) const {
+	for( int i=0; i<numCpus; i++ ) {
+		if ( cpus[i].core == core )
+			return cpus[i].node;
+	}
+	return -1;
+}
+
+/*
+================
+CpuTopology::GetSpreadCpu
+================
+*/
+int CpuTopology::GetSpreadCpu( int index, int firstCore ) const {
+	int numUsable = numCores - firstCore;
+	if ( index < 0 || firstCore < 0 || numUsable <= 0 )
+		return -1;
+
+	// one thread per core first, then the SMT siblings
+	for( int thread=0; ; thread++ ) {
+		int found = 0;
+		for( int core=firstCore; core<numCores; core++ ) {
+			int cpu = GetCoreCpu( core, thread );
+			if ( cpu == -1 )
+				continue;
+			if ( index == 0 )
+				return cpu;
+			index--;
+			found++;
+		}
+		if ( found == 0 )
+			return -1;
+	}
 }
 
 /*
@@ -116,14 +294,101 @@ void TLS_Data::Cleanup( void ) {
 
 ==============================================================================
 */
+static TLS<int> readerStripe(-1);	// the reader counter index of the thread
+static AtomicInt nextReaderStripe;
+
+/*
+================
+SharedMutex::SharedMutex
+================
+*/
+SharedMutex::SharedMutex( bool striped ) {
+	exclusive = false;
+	exclusiveRequests = 0;
+	numShared = 0;
+	stripes = NULL;
+	stripeMask = 0;
+	if ( striped ) {
+		int num = 2;
+		int numCpus = static_cast<int>( ogst::thread::hardware_concurrency() );
+		while( num < numCpus && num < 64 )
+			num <<= 1;
+		stripes = new ReaderStripe[num];
+		stripeMask = num - 1;
+	}
+}
+
+/*
+================
+SharedMutex::~SharedMutex
+================
+*/
+SharedMutex::~SharedMutex() {
+	delete[] stripes;
+}
+
+/*
+================
+SharedMutex::GetStripe
+================
+*/
+AtomicInt &SharedMutex::GetStripe( void ) {
+	int *index = readerStripe.Get();
+	if ( *index == -1 )
+		*index = nextReaderStripe.Increment();
+	return stripes[*index & stripeMask].count;
+}
+
+/*
+================
+SharedMutex::ReleaseStripe
+================
+*/
+void SharedMutex::ReleaseStripe( AtomicInt &count ) {
+	// the mutex makes sure a writer can't miss this between checking the counters and waiting
+	if ( count.Decrement() == 0 && writerActive.Get() ) {
+		mutex.lock();
+		exclusiveCond.notify_all();
+		mutex.unlock();
+	}
+}
+
+/*
+================
+SharedMutex::HasStripedReaders
+================
+*/
+bool SharedMutex::HasStripedReaders( void ) const {
+	for( int i=0; i<=stripeMask; i++ ) {
+		if ( stripes[i].count.Get() != 0 )
+			return true;
+	}
+	return false;
+}
+
 /*
 ================
 SharedMutex::lock_shared
 ================
 */
 void SharedMutex::lock_shared( void ) {
+	if ( stripes ) {
+		AtomicInt &count = GetStripe();
+		for(;;) {
+			// Increment is a full barrier, so either we see the writer or it sees us
+			count.Increment();
+			if ( writerActive.Get() == 0 )
+				return;
+			ReleaseStripe( count );
+
+			ogst::unique_lock<ogst::mutex> lock(mutex);
+			while( writerActive.Get() )
+				sharedCond.wait(lock);
+		}
+	}
+
 	ogst::unique_lock<ogst::mutex> lock(mutex);
-	while( exclusiveRequests )
+	while( exclusive || exclusiveRequests )
 		sharedCond.wait(lock);
 	numShared++;
 }
@@ -134,10 +399,15 @@ SharedMutex::unlock_shared
 ================
 */
 void SharedMutex::unlock_shared( void ) {
+	if ( stripes ) {
+		ReleaseStripe( GetStripe() );
+		return;
+	}
+
 	mutex.lock();
 	numShared--;
 	if ( exclusiveRequests && numShared == 0 )
-		exclusiveCond.notify_one();
+		exclusiveCond.notify_all();
 	mutex.unlock();
 }
 
@@ -149,11 +419,18 @@ SharedMutex::lock
 void SharedMutex::lock( void ) {
 	ogst::unique_lock<ogst::mutex> lock(mutex);
 	exclusiveRequests++;
-	while( exclusive )
-		exclusiveCond.wait(lock);
+	if ( stripes ) {
+		// keeps new readers out while we wait
+		writerActive.Set( 1 );
+		MemoryFence();
+		while( exclusive || HasStripedReaders() )
+			exclusiveCond.wait(lock);
+	} else {
+		while( exclusive || numShared )
+			exclusiveCond.wait(lock);
+	}
 	exclusiveRequests--;
 	exclusive = true;
-	lock.release();
 }
 
 /*
@@ -162,10 +439,15 @@ SharedMutex::unlock
 ================
 */
 void SharedMutex::unlock( void ) {
+	mutex.lock();
+	exclusive = false;
 	if ( exclusiveRequests > 0 )
-		exclusiveCond.notify_one();
-	else
+		exclusiveCond.notify_all();
+	else {
+		if ( stripes )
+			writerActive.Set( 0 );
 		sharedCond.notify_all();
+	}
 	mutex.unlock();
 }
 
@@ -188,6 +470,8 @@ Thread::Thread() {
 	isRunning		= false;
 	keepRunning		= true;
 	nativeId		= 0;
+	affinity		= -1;
+	lowPriority		= false;
 }
 
 /*
@@ -197,6 +481,9 @@ Thread::Start
 */
 bool Thread::Start( const char *_name, bool waitForInit ) {
 	name = _name;
+
+	// set before the thread exists, so a Stop() right after Start() won't delete a starting thread
+	isRunning = true;
 	if ( !waitForInit ) {
 		thread = ogst::thread( &Thread::RunThread, this, (Condition *)NULL );
 		return true;
@@ -215,9 +502,11 @@ Thread::RunThread
 ================
 */
 void Thread::RunThread( Condition *initCondition ) {
-	isRunning = true;
-
 	PlatformInit();
+	if ( affinity != -1 )
+		SetCurrentAffinity( affinity );
+	if ( lowPriority )
+		SetCurrentLowPriority( true );
 
 	initResult = Init();
 	if ( initCondition )
@@ -255,5 +544,70 @@ void Thread::Stop( bool blocking ) {
 	}
 }
 
+/*
+================
+Thread::SetAffinity
+================
+*/
+void Thread::SetAffinity( int cpu ) {
+	affinity = cpu;
+	if ( isRunning && ogst::this_thread::get_id() == thread.get_id() )
+		SetCurrentAffinity( cpu );
 }
 
+/*
+================
+Thread::SetLowPriority
+================
+*/
+void Thread::SetLowPriority( bool low ) {
+	lowPriority = low;
+	if ( isRunning && ogst::this_thread::get_id() == thread.get_id() )
+		SetCurrentLowPriority( low );
+}
+
+/*
+================
+Thread::WakeUp
+================
+*/
+void Thread::WakeUp( void ) {
+	// Only take the lock if the thread is actually sleeping
+	if ( wakeUpState.Exchange( WAKEUP_NOTIFIED ) == WAKEUP_SLEEPING )
+		wakeUpEvent.Signal();
+}
+
+/*
+================
+Thread::ConsumeWakeUp
+================
+*/
+bool Thread::ConsumeWakeUp( void ) {
+	return wakeUpState.Get() == WAKEUP_NOTIFIED && wakeUpState.CompareExchange( WAKEUP_EMPTY, WAKEUP_NOTIFIED ) == WAKEUP_NOTIFIED;
+}
+
+/*
+================
+Thread::WaitForWakeUp
+================
+*/
+bool Thread::WaitForWakeUp( int ms ) {
+	ConsumeWakeUpCheck check( this );
+	if ( waitPolicy.Spin( check ) )
+		return true;
+
+	wakeUpEvent.Lock();
+	// WakeUp() swaps in WAKEUP_NOTIFIED and signals under the lock, so it can't get lost in between
+	if ( wakeUpState.CompareExchange( WAKEUP_SLEEPING, WAKEUP_EMPTY ) == WAKEUP_EMPTY ) {
+		if ( ms < 0 ) {
+			while( wakeUpState.Get() == WAKEUP_SLEEPING )
+				wakeUpEvent.Wait();
+		} else
+			wakeUpEvent.Wait( ms );
+	}
+	bool notified = wakeUpState.Exchange( WAKEUP_EMPTY ) == WAKEUP_NOTIFIED;
+	wakeUpEvent.Unlock();
+	return notified;
+}
+
+}
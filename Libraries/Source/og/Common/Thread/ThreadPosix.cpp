@@ -34,9 +34,14 @@ freely, subject to the following restrictions:
 #if OG_LINUX || OG_MACOS_X
 
 #include <pthread.h>
-#include <sys/prctl.h>
-//#include <sys/types.h>
-#include <sys/syscall.h>
+#include <stdio.h>
+#if OG_LINUX
+	#include <sched.h>
+	#include <sys/prctl.h>
+	//#include <sys/types.h>
+	#include <sys/syscall.h>
+	#include <sys/resource.h>
+#endif
 
 
 namespace og {
@@ -56,12 +61,16 @@ namespace og {
 
 ==============================================================================
 */
+static int nextTlsSlot = 0;	// constant initialized, so TLS objects can be created during static initialization
+
 /*
 ================
 TLS_Index::TLS_Index
 ================
 */
 TLS_Index::TLS_Index() : data(NULL) {
+	slot = __sync_fetch_and_add( &nextTlsSlot, 1 );
+
 	pthread_key_t key;
 	int result = pthread_key_create( &key, NULL );
 	OG_ASSERT( result == 0 );
@@ -100,7 +109,107 @@ TLS_Index::SetValue
 */
 void TLS_Index::SetValue( void *value ) const {
 	OG_ASSERT( data != NULL );
-	pthread_setspecific( *static_cast<pthread_key_t *>(data), data );
+	pthread_setspecific( *static_cast<pthread_key_t *>(data), value );
+}
+
+/*
+==============================================================================
+
+  CpuTopology
+
+==============================================================================
+*/
+#if OG_LINUX
+/*
+================
+ReadSysInt
+================
+*/
+static int ReadSysInt( const char *path, int defaultValue ) {
+	int value = defaultValue;
+	FILE *file = fopen( path, "r" );
+	if ( file ) {
+		if ( fscanf( file, "%d", &value ) != 1 )
+			value = defaultValue;
+		fclose( file );
+	}
+	return value;
+}
+
+/*
+================
+ReadCpuList
+
+Parses a sysfs cpu list like "0-3,8-11" into a set
+================
+*/
+static bool ReadCpuList( const char *path, cpu_set_t *set ) {
+	FILE *file = fopen( path, "r" );
+	if ( !file )
+		return false;
+
+	CPU_ZERO( set );
+	int from, to;
+	char sep;
+	while( fscanf( file, "%d", &from ) == 1 ) {
+		to = from;
+		sep = static_cast<char>( fgetc( file ) );
+		if ( sep == '-' ) {
+			if ( fscanf( file, "%d", &to ) != 1 )
+				break;
+			sep = static_cast<char>( fgetc( file ) );
+		}
+		for( int i=from; i<=to && i<CPU_SETSIZE; i++ )
+			CPU_SET( i, set );
+		if ( sep != ',' )
+			break;
+	}
+	fclose( file );
+	return true;
+}
+#endif
+
+/*
+================
+CpuTopology::PlatformProbe
+================
+*/
+void CpuTopology::PlatformProbe( void ) {
+#if OG_LINUX
+	cpu_set_t allowed;
+	if ( sched_getaffinity( 0, sizeof(allowed), &allowed ) != 0 )
+		return;
+
+	// node of each cpu, the node directories only exist on NUMA kernels
+	static int cpuNode[CPU_SETSIZE];
+	for( int i=0; i<CPU_SETSIZE; i++ )
+		cpuNode[i] = 0;
+	char path[128];
+	cpu_set_t nodeCpus;
+	int numMissing = 0;
+	for( int node=0; numMissing < 8; node++ ) {
+		sprintf( path, "/sys/devices/system/node/node%d/cpulist", node );
+		if ( !ReadCpuList( path, &nodeCpus ) ) {
+			numMissing++;	// node ids can have gaps
+			continue;
+		}
+		for( int i=0; i<CPU_SETSIZE; i++ ) {
+			if ( CPU_ISSET( i, &nodeCpus ) )
+				cpuNode[i] = node;
+		}
+	}
+
+	int package, coreId;
+	for( int i=0; i<CPU_SETSIZE; i++ ) {
+		if ( !CPU_ISSET( i, &allowed ) )
+			continue;
+		sprintf( path, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", i );
+		package = ReadSysInt( path, 0 );
+		sprintf( path, "/sys/devices/system/cpu/cpu%d/topology/core_id", i );
+		coreId = ReadSysInt( path, i );
+		AddCpu( i, package, coreId, cpuNode[i] );
+	}
+#endif
 }
 
 /*
@@ -110,6 +219,43 @@ void TLS_Index::SetValue( void *value ) const {
 
 ==============================================================================
 */
+/*
+================
+Thread::SetCurrentAffinity
+================
+*/
+bool Thread::SetCurrentAffinity( int cpu ) {
+#if OG_LINUX
+	cpu_set_t set;
+	CPU_ZERO( &set );
+	if ( cpu == -1 ) {
+		for( int i=0; i<CPU_SETSIZE; i++ )
+			CPU_SET( i, &set );
+	} else if ( cpu >= 0 && cpu < CPU_SETSIZE )
+		CPU_SET( cpu, &set );
+	else
+		return false;
+	return sched_setaffinity( 0, sizeof(set), &set ) == 0;
+#else
+	// Mac OS X only supports affinity hints between threads
+	return false;
+#endif
+}
+
+/*
+================
+Thread::SetCurrentLowPriority
+================
+*/
+bool Thread::SetCurrentLowPriority( bool low ) {
+#if OG_LINUX
+	// Linux threads have their own nice value, going back to 0 might need privileges
+	return setpriority( PRIO_PROCESS, static_cast<id_t>( syscall(SYS_gettid) ), low ? 10 : 0 ) == 0;
+#else
+	//! @todo	Mac OS X
+	return false;
+#endif
+}
 
 /*
 ================
@@ -127,7 +273,9 @@ void Thread::PlatformInit( void ) {
 
 	prctl(PR_SET_NAME, name.c_str(), 0, 0, 0, 0) ;
 #elif OG_MACOS_X
-#warning "Need MacOS here FIXME"
+	// Set thread name ( only possible from within the thread )
+	pthread_setname_np( name.c_str() );
+#warning "Need MacOS native id here FIXME"
 #endif
 }
 
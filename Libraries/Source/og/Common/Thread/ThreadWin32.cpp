@@ -42,12 +42,16 @@ namespace og {
 
 ==============================================================================
 */
+static long nextTlsSlot = 0;	// constant initialized, so TLS objects can be created during static initialization
+
 /*
 ================
 TLS_Index::TLS_Index
 ================
 */
 TLS_Index::TLS_Index() : data(NULL) {
+	slot = InterlockedIncrement( &nextTlsSlot ) - 1;
+
 	uLong index = TlsAlloc();
 	OG_ASSERT( index != TLS_OUT_OF_INDEXES );
 
@@ -88,6 +92,67 @@ void TLS_Index::SetValue( void *value ) const {
 	TlsSetValue( *static_cast<uLong *>(data), value );
 }
 
+/*
+==============================================================================
+
+  CpuTopology
+
+==============================================================================
+*/
+/*
+================
+CpuTopology::PlatformProbe
+================
+*/
+void CpuTopology::PlatformProbe( void ) {
+	DWORD_PTR processMask, systemMask;
+	if ( !GetProcessAffinityMask( GetCurrentProcess(), &processMask, &systemMask ) )
+		return;
+
+	DWORD size = 0;
+	GetLogicalProcessorInformation( NULL, &size );
+	if ( GetLastError() != ERROR_INSUFFICIENT_BUFFER )
+		return;
+	int num = size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION *info = new SYSTEM_LOGICAL_PROCESSOR_INFORMATION[num];
+	if ( !GetLogicalProcessorInformation( info, &size ) ) {
+		delete[] info;
+		return;
+	}
+
+	const int maskBits = sizeof(DWORD_PTR) * 8;
+	int cpuPackage[maskBits], cpuCore[maskBits], cpuNode[maskBits];
+	for( int i=0; i<maskBits; i++ ) {
+		cpuPackage[i] = 0;
+		cpuCore[i] = -1;
+		cpuNode[i] = 0;
+	}
+
+	int numCoreEntries = 0, numPackageEntries = 0;
+	for( int i=0; i<num; i++ ) {
+		for( int cpu=0; cpu<maskBits; cpu++ ) {
+			if ( (info[i].ProcessorMask & (static_cast<DWORD_PTR>(1) << cpu)) == 0 )
+				continue;
+			if ( info[i].Relationship == RelationProcessorCore )
+				cpuCore[cpu] = numCoreEntries;
+			else if ( info[i].Relationship == RelationProcessorPackage )
+				cpuPackage[cpu] = numPackageEntries;
+			else if ( info[i].Relationship == RelationNumaNode )
+				cpuNode[cpu] = info[i].NumaNode.NodeNumber;
+		}
+		if ( info[i].Relationship == RelationProcessorCore )
+			numCoreEntries++;
+		else if ( info[i].Relationship == RelationProcessorPackage )
+			numPackageEntries++;
+	}
+	delete[] info;
+
+	for( int cpu=0; cpu<maskBits; cpu++ ) {
+		if ( (processMask & (static_cast<DWORD_PTR>(1) << cpu)) && cpuCore[cpu] != -1 )
+			AddCpu( cpu, cpuPackage[cpu], cpuCore[cpu], cpuNode[cpu] );
+	}
+}
+
 /*
 ==============================================================================
 
@@ -95,6 +160,31 @@ void TLS_Index::SetValue( void *value ) const {
 
 ==============================================================================
 */
+/*
+================
+Thread::SetCurrentAffinity
+================
+*/
+bool Thread::SetCurrentAffinity( int cpu ) {
+	DWORD_PTR mask, systemMask;
+	if ( cpu == -1 ) {
+		if ( !GetProcessAffinityMask( GetCurrentProcess(), &mask, &systemMask ) )
+			return false;
+	} else if ( cpu >= 0 && cpu < static_cast<int>( sizeof(DWORD_PTR) * 8 ) )
+		mask = static_cast<DWORD_PTR>(1) << cpu;
+	else
+		return false;
+	return SetThreadAffinityMask( GetCurrentThread(), mask ) != 0;
+}
+
+/*
+================
+Thread::SetCurrentLowPriority
+================
+*/
+bool Thread::SetCurrentLowPriority( bool low ) {
+	return SetThreadPriority( GetCurrentThread(), low ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_NORMAL ) != 0;
+}
 
 /*
 ================
@@ -564,7 +564,7 @@ public:
 		for( i = 0; i < num; i++ )
 			fullList.Append( cvarDataList.GetKey(i) );
 
-		fullList.Sort( StringListICmp, true );
+		fullList.SortWith( StringListILess(), true );
 		num = fullList.Num();
 		Format complete( "$* $*" );
 		for( i = 0; i < num; i++ ) {
@@ -334,7 +334,8 @@ bool FileSystem::MakePath( const char *path ) {
 FileSystemEx::FileSystemEx
 ================
 */
-FileSystemEx::FileSystemEx() {
+FileSystemEx::FileSystemEx() : sharedMutex(true) {
+	// opening files takes a shared lock from every loader thread, ChangeMod & co are rare
 	*notFoundWarning = true;
 	pureMode = false;
 }
@@ -381,12 +382,10 @@ FileSystemEx::Run
 */
 void FileSystemEx::Run( void ) {
 	// All this does is watch the open/close file events and on shutdown clear all files that where still open.
-	wakeUpEvent.Lock();
 	while( keepRunning ) {
 		eventQueue.ProcessAll();
-		wakeUpEvent.Wait();
+		WaitForWakeUp();
 	}
-	wakeUpEvent.Unlock();
 
 	// Consume remaining events
 	eventQueue.ProcessAll();
@@ -485,7 +484,7 @@ void FileSystemEx::AddResourceDir( const char *name, pfListId listId ) {
 
 		if ( !files.IsEmpty() ) {
 			// Add all files in alphabetic order
-			files.Sort( StringListICmp, false );
+			files.SortWith( StringListILess() );
 			PakFileEx *pakFile;
 			max2 = files.Num();
 			for( int j=0; j<max2; j++ ) {
@@ -1023,7 +1022,7 @@ FileList *FileSystemEx::GetFileList( const char *dir, const char *extension, int
 	}
 
 	// Remove double entries
-	fileList->files.Sort( StringListICmp, true );
+	fileList->files.SortWith( StringListILess(), true );
 	return fileList;
 }
 
@@ -40,7 +40,7 @@ OG_INLINE void FontSetColor( const Color &color ) { glColor4f( color.r, color.g,
 static float screenScale = 1.0f;
 static DictEx<FontFamily> fontFamilies;
 static FontFamily *defaultFamily = NULL;
-static LinkedList<FontEx> fontList;
+static SlotMap<FontEx *> fontList;
 
 const byte	MASKBITS	= 0x3F;
 const byte	MASK1BIT	= 0x80;
@@ -706,6 +706,9 @@ Font::Shutdown
 ================
 */
 void Font::Shutdown( void ) {
+	int num = fontList.Num();
+	for( int i=0; i<num; i++ )
+		delete fontList[i];
 	fontList.Clear();
 	fontFamilies.Clear();
 	defaultFamily = NULL;
@@ -719,11 +722,9 @@ Font::SetScreenScale
 */
 void Font::SetScreenScale( float scale ) {
 	screenScale = scale;
-	LinkedList<FontEx>::nodeType *node = fontList.GetFirstNode();
-	while( node != NULL ) {
-		node->value.UpdateSize();
-		node = node->GetNext();
-	}
+	int num = fontList.Num();
+	for( int i=0; i<num; i++ )
+		fontList[i]->UpdateSize();
 }
 
 /*
@@ -732,8 +733,10 @@ Font::Create
 ================
 */
 Font *Font::Create( const char *family, float size, float spacing, float defR, float defG, float defB, float defA ) {
-	fontList.Alloc().Init( family, size, spacing, defR, defG, defB, defA );
-	return &fontList.GetLastNode()->value;
+	FontEx *font = new FontEx;
+	font->Init( family, size, spacing, defR, defG, defB, defA );
+	font->handle = fontList.Add( font );
+	return font;
 }
 
 /*
@@ -759,7 +762,8 @@ void Font::Free( Font *font ) {
 			}
 		}
 	}
-	fontList.Remove( fontEx->node );
+	fontList.Remove( fontEx->handle );
+	delete fontEx;
 }
 
 }
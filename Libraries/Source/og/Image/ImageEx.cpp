@@ -52,7 +52,8 @@ int		ImageEx::magFilter = GL_LINEAR;
 int		ImageEx::maxTextureSize = 256;
 int		ImageEx::jpegQuality = 90;
 
-static DictEx<ImageEx> imageList;
+static SlotMap<ImageEx *> imageList;
+static HashIndex imageHash;	// name hash to index in imageList
 static DictEx<ImageFile *> imageFileTypes;
 static Image *defaultImage = NULL;
 
@@ -75,9 +76,11 @@ public:
 	}
 	void	Synchronize( void ) {
 		if ( file ) {
-			ImageEx &img = imageList[filename.c_str()];
-			if ( file->Upload( img ) )
-				img.time = imageFS->FileTime( filename.c_str() );
+			ImageEx *img = ImageEx::FindImage( filename.c_str() );
+			if ( img == NULL )
+				img = ImageEx::CreateImage( filename.c_str() );
+			if ( file->Upload( *img ) )
+				img->time = imageFS->FileTime( filename.c_str() );
 		}
 	}
 
@@ -133,7 +136,7 @@ Image::Shutdown
 ================
 */
 void Image::Shutdown( void ) {
-	imageList.Clear();
+	ImageEx::FreeAllImages();
 	imageFileTypes.Clear();
 	defaultImage = NULL;
 	imageFS = NULL;
@@ -151,7 +154,7 @@ uInt Image::ReloadImages( bool force, PreloadManager *preloadManager ) {
 	uInt numReloads = 0;
 	int num = imageList.Num();
 	for( int i=0; i<num; i++ ) {
-		if ( imageList[i].ReloadImage( force, preloadManager ) )
+		if ( imageList[i]->ReloadImage( force, preloadManager ) )
 			numReloads++;
 	}
 
@@ -167,13 +170,13 @@ Image *Image::Find( const char *filename ) {
 	if ( filename[0] == '\0' )
 		return defaultImage;
 
-	int index = imageList.Find( filename );
-	if ( index != -1 )
-		return &imageList[index];
+	ImageEx *img = ImageEx::FindImage( filename );
+	if ( img != NULL )
+		return img;
 
-	ImageEx *img = &imageList[filename];
+	img = ImageEx::CreateImage( filename );
 	if ( !img->UploadImage( filename ) ) {
-		imageList.Remove( imageList.Find( filename ) );
+		ImageEx::FreeImage( img );
 		return defaultImage;
 	}
 	return img;
@@ -184,14 +187,7 @@ Image::Free
 ================
 */
 void Image::Free( Image *image ) {
-	//! @todo	can this be done nicer ?
-	int max = imageList.Num();
-	for( int i=0; i<max; i++ ) {
-		if ( &imageList[i] == image ) {
-			imageList.Remove(i);
-			return;
-		}
-	}
+	ImageEx::FreeImage( static_cast<ImageEx *>(image) );
 }
 
 /*
@@ -244,9 +240,9 @@ void Image::SetFilters( int min, int mag ) {
 	// Update filters for all images.
 	int num = imageList.Num();
 	for( int i=0; i<num; i++ ) {
-		ImageEx &img = imageList[i];
-		if ( img.mipmap ) {
-			img.BindTexture();
+		ImageEx *img = imageList[i];
+		if ( img->mipmap ) {
+			img->BindTexture();
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, ImageEx::minFilter);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, ImageEx::magFilter);
 		}
@@ -297,6 +293,66 @@ ImageEx::~ImageEx() {
 		glDeleteTextures( 1, &glTextureNum );
 }
 
+/*
+================
+ImageEx::FindImage
+================
+*/
+ImageEx *ImageEx::FindImage( const char *name ) {
+	int hash = HashIndex::GenerateKey( name, false );
+	for( int i=imageHash.First( hash ); i!=-1; i=imageHash.Next() ) {
+		if ( imageList[i]->name.Icmp( name ) == 0 )
+			return imageList[i];
+	}
+	return NULL;
+}
+
+/*
+================
+ImageEx::CreateImage
+================
+*/
+ImageEx *ImageEx::CreateImage( const char *name ) {
+	ImageEx *image = new ImageEx;
+	image->name = name;
+	imageHash.Add( HashIndex::GenerateKey( name, false ), imageList.Num() );
+	image->handle = imageList.Add( image );
+	return image;
+}
+
+/*
+================
+ImageEx::FreeImage
+================
+*/
+void ImageEx::FreeImage( ImageEx *image ) {
+	int index = imageList.GetIndex( image->handle );
+	OG_ASSERT( index != -1 );
+	if ( index == -1 )
+		return;
+
+	// the last image moves into the gap
+	int last = imageList.Num() - 1;
+	imageHash.Remove( HashIndex::GenerateKey( image->name.c_str(), false ), index, false );
+	if ( index != last )
+		imageHash.Reindex( HashIndex::GenerateKey( imageList[last]->name.c_str(), false ), last, index );
+	imageList.Remove( image->handle );
+	delete image;
+}
+
+/*
+================
+ImageEx::FreeAllImages
+================
+*/
+void ImageEx::FreeAllImages( void ) {
+	int num = imageList.Num();
+	for( int i=0; i<num; i++ )
+		delete imageList[i];
+	imageList.Clear();
+	imageHash.Clear();
+}
+
 /*
 ================
 ImageEx::BindTexture
@@ -66,9 +66,16 @@ namespace og {
 
 		bool	UploadImage( const char *filename );
 		bool	ReloadImage( bool force, PreloadManager *preloadManager=NULL );
+
+		static ImageEx *FindImage( const char *name );
+		static ImageEx *CreateImage( const char *name );
+		static void		FreeImage( ImageEx *image );
+		static void		FreeAllImages( void );
 		
 		static int	GetFileTypeIndex( String &filename );
 
+		String	name;		// The name it was registered with
+		SlotHandle handle;	// The handle in the image list
 		String	fullpath;
 		uInt	glTextureNum;
 		uInt	width, height;
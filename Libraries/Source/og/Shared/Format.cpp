@@ -59,33 +59,63 @@ Format::Format
 ================
 */
 Format::Format( const char *fmt ) {
-	firstFormatEntry = NULL;
-	lastFormatEntry = NULL;
-	numFormatEntries = 0;
+	buffer = inlineBuffer;
+	bufferSize = INLINE_SIZE;
+	fixedSize = false;
+	Reset( false, fmt );
+}
+Format::Format( char *dest, int size, const char *fmt ) {
+	OG_ASSERT( dest != NULL && size > 0 );
+	buffer = dest;
+	bufferSize = size;
+	fixedSize = true;
 	Reset( false, fmt );
 }
+Format::Format( const Format &other ) {
+	buffer = inlineBuffer;
+	bufferSize = INLINE_SIZE;
+	fixedSize = false;
+	Copy( other );
+}
+
 /*
 ================
 Format::~Format
 ================
 */
 Format::~Format() {
-	DeleteFormatEntries();
+	if ( !fixedSize && buffer != inlineBuffer )
+		delete[] buffer;
 }
 
 /*
 ================
-Format::DeleteFormatEntries
+Format::operator=
 ================
 */
-void Format::DeleteFormatEntries( void ){
-	FormatEntry *temp;
-	while( firstFormatEntry ) {
-		temp = firstFormatEntry;
-		firstFormatEntry = firstFormatEntry->next;
-		delete temp;
-	}
-	numFormatEntries = 0;
+Format &Format::operator=( const Format &other ) {
+	if ( &other != this )
+		Copy( other );
+	return *this;
+}
+
+/*
+================
+Format::Copy
+================
+*/
+void Format::Copy( const Format &other ) {
+	memcpy( fmtBuffer, other.fmtBuffer, FMT_SIZE );
+	memcpy( entries, other.entries, sizeof(FormatEntry) * other.numFormatEntries );
+	prefixLength = other.prefixLength;
+	numFormatEntries = other.numFormatEntries;
+	hasFormat = other.hasFormat;
+	paramCount = other.paramCount;
+	fillChar = other.fillChar;
+	floatPrecision = other.floatPrecision;
+
+	offset = 0;
+	Append( other.buffer, other.offset, 0 );
 }
 
 /*
@@ -96,109 +126,153 @@ Format::Reset
 void Format::Reset( bool keep, const char *fmt ) {
 	floatPrecision = -1;
 	fillChar = ' ';
+	offset = 0;
+	buffer[0] = '\0';
 
-	if ( keep ) {
-		if ( !hasFormat ) {
-			offset = 0;
-			paramCount = -1;
-		} else {
-			offset = strlen( fmtBuffer );
-			memcpy( buffer, fmtBuffer, offset );
-			if ( paramCount > 0 )
-				paramCount = 0;
-
-			FormatEntry *entry = firstFormatEntry;
-			while( entry ) {
-				if ( entry->takeInput == 1 )
-					entry->takeInput = 2;
-				entry = entry->next;
-			}
+	if ( !keep )
+		Parse( fmt );
+	else if ( hasFormat ) {
+		if ( paramCount > 0 )
+			paramCount = 0;
+		for( int i=0; i<numFormatEntries; i++ ) {
+			if ( entries[i].takeInput == 1 )
+				entries[i].takeInput = 2;
 		}
-		buffer[offset] = '\0';
-		return;
 	}
-	DeleteFormatEntries();
 
-	hasFormat = (fmt != NULL);
-	if ( !hasFormat ) {
-		offset = 0;
+	if ( !hasFormat )
 		paramCount = -1;
-		fmtBuffer[0] = '\0';
-	} else {
-		strcpy( fmtBuffer, fmt );
-		fmtBuffer[255] = '\0';
-
-		int end;
-		offset = -1;
-		for( int r=0, w=0; fmtBuffer[r] != '\0'; r++, w++ ) {
-			if ( fmtBuffer[r] == '$' ) {
-				if ( fmtBuffer[r+1] == '$' )
-					r++;
-				else {
-					FormatEntry *entry = new FormatEntry;
-					if ( firstFormatEntry == NULL )
-						firstFormatEntry = lastFormatEntry = entry;
+	else
+		Append( fmtBuffer, prefixLength, 0 );
+}
+
+/*
+================
+Format::Parse
+================
+*/
+void Format::Parse( const char *fmt ) {
+	numFormatEntries = 0;
+	prefixLength = 0;
+	hasFormat = (fmt != NULL);
+	if ( !hasFormat )
+		return;
+
+	FormatEntry *entry = NULL;
+	int w = 0;
+	for( int r=0; fmt[r] != '\0'; r++ ) {
+		if ( fmt[r] == '$' ) {
+			if ( fmt[r+1] == '$' )
+				r++;
+			else {
+				int p = r + 1;
+				int fieldWidth = 0;
+				int takeInput = 0;
+				if ( fmt[p] == '?' ) {
+					takeInput = 2;
+					p++;
+				} else if ( fmt[p] == '+' || fmt[p] == '-' ) {
+					bool negative = fmt[p] == '-';
+					for ( p++; String::IsDigit(fmt[p]); p++ )
+						fieldWidth = 10 * fieldWidth + (fmt[p] - '0');
+					if ( negative )
+						fieldWidth *= -1;
+				}
+				// This assert gets triggered when you specify more than MAX_ENTRIES parameters.
+				OG_ASSERT( fmt[p] != '*' || numFormatEntries < MAX_ENTRIES );
+				if ( fmt[p] == '*' && numFormatEntries < MAX_ENTRIES ) {
+					if ( entry == NULL )
+						prefixLength = w;
 					else
-						lastFormatEntry = lastFormatEntry->next = entry;
-					numFormatEntries++;
-
-					entry->fieldWidth = 0;
-					end = r;
-					if ( fmtBuffer[r+1] == '?' ) {
-						entry->takeInput = 2;
-						r++;
-					} else if ( fmtBuffer[r+1] == '+' || fmtBuffer[r+1] == '-' ) {
-						bool negative = fmtBuffer[r+1] == '-';
-						entry->takeInput = 0;
-						for ( r += 2; String::IsDigit(fmtBuffer[r]); r++ )
-							entry->fieldWidth = 10 * entry->fieldWidth + (fmtBuffer[r] - '0');
-						if ( negative )
-							entry->fieldWidth *= -1;
-						r--;
-					}
-					if ( fmtBuffer[r+1] == '*' ) {
-						fmtBuffer[w] = '\0';
-						if ( offset == -1 ) {
-							memcpy( buffer, fmtBuffer, r );
-							offset = end;
-						}
-						r++;
-						entry->append = fmtBuffer + r + 1;
-						w = r;
-						continue;
-					}
-					OG_DEBUG_BREAK()
-					//! @todo	error ?
+						entry->appendLength = w - entry->append;
+
+					entry = &entries[numFormatEntries++];
+					entry->append = w;
+					entry->fieldWidth = fieldWidth;
+					entry->takeInput = takeInput;
+					r = p;
+					continue;
 				}
+				OG_DEBUG_BREAK()
+				//! @todo	error ?
 			}
-			fmtBuffer[w] = fmtBuffer[r];
-		}
-		// This assert gets triggered when you have no parameters specified in the format.
-		//! @todo	add an error here ?
-		OG_ASSERT( offset != -1 );
-		if ( offset != -1 ) {
-			paramCount = 0;
-		} else {
-			// no params specified, act like this is the first parameter
-			offset = strlen( fmtBuffer );
-			memcpy( buffer, fmtBuffer, offset );
-			paramCount = -1;
 		}
+		// This assert gets triggered when the format is longer than FMT_SIZE.
+		OG_ASSERT( w < FMT_SIZE );
+		if ( w >= FMT_SIZE )
+			break;
+		fmtBuffer[w++] = fmt[r];
 	}
-	buffer[offset] = '\0';
+	if ( entry == NULL )
+		prefixLength = w;
+	else
+		entry->appendLength = w - entry->append;
+
+	// This assert gets triggered when you have no parameters specified in the format.
+	//! @todo	add an error here ?
+	OG_ASSERT( numFormatEntries > 0 );
+
+	// no params specified, act like this is the first parameter
+	paramCount = numFormatEntries > 0 ? 0 : -1;
+}
+
+/*
+================
+Format::Reserve
+================
+*/
+int Format::Reserve( int len ) {
+	int needed = offset + len + 1;
+	if ( needed > bufferSize && !fixedSize && bufferSize < MAX_SIZE ) {
+		int newSize = bufferSize * 2;
+		while( newSize < needed )
+			newSize *= 2;
+		newSize = Min( newSize, MAX_SIZE );
+
+		char *newBuffer = new char[newSize];
+		memcpy( newBuffer, buffer, offset + 1 );
+		if ( buffer != inlineBuffer )
+			delete[] buffer;
+		buffer = newBuffer;
+		bufferSize = newSize;
+	}
+	return Min( len, bufferSize - 1 - offset );
 }
 
 /*
 ================
-Format::GetFormatEntry
+Format::Append
 ================
 */
-Format::FormatEntry *Format::GetFormatEntry( int index ) {
-	//! @todo: do this nicer
-	FormatEntry *entry = firstFormatEntry;
-	for( int i=0; i<index && entry; i++ )
-		entry = entry->next;
-	return entry;
+void Format::Append( const char *str, int len, int fieldWidth ) {
+	bool alignRight = fieldWidth < 0;
+	if ( alignRight )
+		fieldWidth *= -1;
+	int fill = Max( fieldWidth - len, 0 );
+	int total = len + fill;
+	int space = Reserve( total );
+	bool overflow = space < total;
+
+	int num;
+	if ( alignRight ) {
+		num = Min( fill, space );
+		memset( buffer + offset, fillChar, num );
+		offset += num;
+		space -= num;
+	}
+	num = Min( len, space );
+	memcpy( buffer + offset, str, num );
+	offset += num;
+	space -= num;
+	if ( !alignRight ) {
+		num = Min( fill, space );
+		memset( buffer + offset, fillChar, num );
+		offset += num;
+	}
+	buffer[offset] = '\0';
+
+	if ( overflow )
+		User::Error( ERR_BUFFER_OVERFLOW, "Format::Append", Format() << bufferSize );
 }
 
 /*
@@ -207,49 +281,16 @@ Format::TryPrint
 ================
 */
 void Format::TryPrint( const char *fmt, ... ) {
-	int size = bufferSize - offset;
-	if ( size > 1 ) {
-		va_list	list;
-		va_start(list, fmt);
-		int ret = vsnPrintf( buffer+offset, size, fmt, list );
-		if ( ret > 0 ) {
-			int fieldWidth = 0;
-			if ( paramCount != -1 && paramCount < numFormatEntries ) {
-				FormatEntry *entry = GetFormatEntry( paramCount );
-				if ( entry )
-					fieldWidth = entry->fieldWidth;
-			}
-			bool alignLeft = true;
-			if ( fieldWidth < 0 ) {
-				fieldWidth *= -1;
-				alignLeft = false;
-			}
-			if ( ret >= fieldWidth )
-				offset += ret;
-			else {
-				if ( !alignLeft ) {
-					int max = Min( offset + fieldWidth - ret, bufferSize-1 );
-					for( ; offset < max; offset++ )
-						buffer[offset] = fillChar;
-					size = bufferSize - offset;
-					if ( size > 1 ) {
-						ret = vsnPrintf( buffer+offset, size, fmt, list );
-						if ( ret > 0 )
-							offset += ret;
-					}
-				} else {
-					offset += ret;
-					int max = Min( offset + fieldWidth - ret, bufferSize-1 );
-					for( ; offset < max; offset++ )
-						buffer[offset] = fillChar;
-					buffer[offset] = '\0';
-				}
-			}
-		}
-		va_end(list);
-		if ( ret == -1 )
-			User::Error( ERR_BUFFER_OVERFLOW, "Format::TryPrint", Format() << size );
+	char temp[1024];
+	va_list	list;
+	va_start(list, fmt);
+	int ret = vsnPrintf( temp, sizeof(temp), fmt, list );
+	va_end(list);
+	if ( ret == -1 ) {
+		User::Error( ERR_BUFFER_OVERFLOW, "Format::TryPrint", Format() << static_cast<int>(sizeof(temp)) );
+		ret = static_cast<int>( String::ByteLength( temp ) );
 	}
+	AppendValue( temp, ret );
 }
 
 /*
@@ -262,9 +303,8 @@ void Format::OnAppend( void ) {
 	//! @todo	add an error here ?
 	OG_ASSERT( paramCount < numFormatEntries );
 	if ( paramCount < numFormatEntries ) {
-		FormatEntry *entry = GetFormatEntry( paramCount++ );
-		if ( entry )
-			TryPrint( "%s", entry->append );
+		FormatEntry &entry = entries[paramCount++];
+		Append( fmtBuffer + entry.append, entry.appendLength, 0 );
 	}
 }
 
@@ -277,12 +317,9 @@ bool Format::CheckVariableInput( void ) {
 	// This assert gets triggered when you add more parameters than where specified in the format.
 	//! @todo	add an error here ?
 	OG_ASSERT( paramCount != -1 && paramCount < numFormatEntries );
-	if ( paramCount < numFormatEntries ) {
-		FormatEntry *entry = GetFormatEntry( paramCount );
-		if ( entry && entry->takeInput == 2 ) {
-			entry->takeInput = 1;
-			return true;
-		}
+	if ( paramCount < numFormatEntries && entries[paramCount].takeInput == 2 ) {
+		entries[paramCount].takeInput = 1;
+		return true;
 	}
 	return false;
 }
@@ -294,9 +331,7 @@ Format::operator <<
 */
 Format &Format::operator << ( int value ) {
 	if ( paramCount != -1 && CheckVariableInput() ) {
-		FormatEntry *entry = GetFormatEntry( paramCount );
-		if ( entry )
-			entry->fieldWidth = value;
+		entries[paramCount].fieldWidth = value;
 		return *this;
 	}
 	TryPrint( "%d", value );
@@ -305,9 +340,7 @@ Format &Format::operator << ( int value ) {
 
 Format &Format::operator << ( uInt value ) {
 	if ( paramCount != -1 && CheckVariableInput() ) {
-		FormatEntry *entry = GetFormatEntry( paramCount );
-		if ( entry )
-			entry->fieldWidth = value;
+		entries[paramCount].fieldWidth = value;
 		return *this;
 	}
 	TryPrint( "%u", value );
@@ -316,9 +349,7 @@ Format &Format::operator << ( uInt value ) {
 
 Format &Format::operator << ( short value ) {
 	if ( paramCount != -1 && CheckVariableInput() ) {
-		FormatEntry *entry = GetFormatEntry( paramCount );
-		if ( entry )
-			entry->fieldWidth = value;
+		entries[paramCount].fieldWidth = value;
 		return *this;
 	}
 	TryPrint( "%d", value );
@@ -327,9 +358,7 @@ Format &Format::operator << ( short value ) {
 
 Format &Format::operator << ( uShort value ) {
 	if ( paramCount != -1 && CheckVariableInput() ) {
-		FormatEntry *entry = GetFormatEntry( paramCount );
-		if ( entry )
-			entry->fieldWidth = value;
+		entries[paramCount].fieldWidth = value;
 		return *this;
 	}
 	TryPrint( "%u", value );
@@ -337,7 +366,7 @@ Format &Format::operator << ( uShort value ) {
 }
 
 Format &Format::operator << ( char value ) {
-	TryPrint( "%c", value );
+	AppendValue( &value, 1 );
 	return Finish();
 }
 
@@ -355,12 +384,12 @@ Format &Format::operator << ( float value ) {
 }
 
 Format &Format::operator << ( const char *value ) {
-	TryPrint( "%s", value );
+	AppendValue( value, static_cast<int>( String::ByteLength( value ) ) );
 	return Finish();
 }
 
 Format &Format::operator << ( const String &value ) {
-	TryPrint( "%s", value.c_str() );
+	AppendValue( value.c_str(), value.ByteLength() );
 	return Finish();
 }
 
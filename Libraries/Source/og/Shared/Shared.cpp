@@ -141,6 +141,23 @@ uInt FNV32( const char *value, bool caseSensitive ) {
 	}
 	return hval;
 }
+uInt FNV32( const char *value, int byteLength, bool caseSensitive ) {
+	uInt hval = 0x811c9dc5;
+	const byte *s = reinterpret_cast<const byte *>(value);
+	const byte *end = s + byteLength;
+	if ( caseSensitive ) {
+		while ( s < end ) {
+			hval ^= static_cast<uInt>(*s++);
+			hval += (hval<<1) + (hval<<4) + (hval<<7) + (hval<<8) + (hval<<24);
+		}
+	} else {
+		while ( s < end ) {
+			hval ^= static_cast<uInt>(tolower(*s++));
+			hval += (hval<<1) + (hval<<4) + (hval<<7) + (hval<<8) + (hval<<24);
+		}
+	}
+	return hval;
+}
 
 /*
 ================
@@ -34,6 +34,27 @@ freely, subject to the following restrictions:
 #include <ctype.h>
 #include <wctype.h>
 
+// AddressSanitizer reports the 16 byte loads that read past the terminator,
+// even though they never cross into another page, so use the scalar code there.
+#if defined(__SANITIZE_ADDRESS__)
+	#define OG_STRING_ASAN 1
+#elif defined(__has_feature)
+	#if __has_feature(address_sanitizer)
+		#define OG_STRING_ASAN 1
+	#endif
+#endif
+
+// SSE2 is part of every x86-64 cpu, 32 bit msvc builds check the cpu at runtime
+#if !defined(OG_STRING_ASAN) && ( defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__SSE2__) )
+	#define OG_STRING_SSE2 1
+	#include <emmintrin.h>
+	#if OG_ASM_MSVC
+		#include <intrin.h>
+	#endif
+#else
+	#define OG_STRING_SSE2 0
+#endif
+
 #if OG_WIN32
 	#include <windows.h>
 #elif OG_LINUX
@@ -207,6 +228,235 @@ int countBytesForLengthReverse( const char *str, int len, int byteLen ) {
 	return i;
 }
 
+/*
+==============================================================================
+
+  SSE2 helpers
+
+  Loads that are aligned to 16 bytes never cross a page boundary, so they can
+  safely read past the terminator of a string. Unaligned loads are only done
+  when the next 16 bytes are on the same page.
+
+==============================================================================
+*/
+#if OG_STRING_SSE2
+
+/*
+================
+UseSSE2
+================
+*/
+OG_INLINE bool UseSSE2( void ) {
+#if defined(_M_IX86) && !defined(__SSE2__)
+	// until SysInfo got initialized this is false and the scalar code gets used
+	return SysInfo::cpu.general.SSE2 != 0;
+#else
+	return true;
+#endif
+}
+
+/*
+================
+FirstBit
+================
+*/
+OG_INLINE int FirstBit( int mask ) {
+#if OG_ASM_MSVC
+	unsigned long index;
+	_BitScanForward( &index, static_cast<unsigned long>(mask) );
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz( static_cast<unsigned int>(mask) );
+#endif
+}
+
+/*
+================
+BitCount16
+================
+*/
+OG_INLINE int BitCount16( int mask ) {
+	mask = mask - ((mask >> 1) & 0x5555);
+	mask = (mask & 0x3333) + ((mask >> 2) & 0x3333);
+	mask = (mask + (mask >> 4)) & 0x0F0F;
+	return (mask + (mask >> 8)) & 0x1F;
+}
+
+/*
+================
+CanLoad16
+================
+*/
+OG_INLINE bool CanLoad16( const char *text ) {
+	return ( reinterpret_cast<size_t>(text) & 4095 ) <= 4096 - 16;
+}
+
+/*
+================
+StartBytes
+
+Bitmask of bytes that are not UTF-8 continuation bytes
+================
+*/
+OG_INLINE int StartBytes( __m128i block ) {
+	__m128i cont = _mm_cmpeq_epi8( _mm_and_si128( block, _mm_set1_epi8( static_cast<char>(MASK2BIT) ) ), _mm_set1_epi8( static_cast<char>(MASK1BIT) ) );
+	return ~_mm_movemask_epi8( cont ) & 0xFFFF;
+}
+
+/*
+================
+BothLengthsSSE2
+================
+*/
+static void BothLengthsSSE2( const char *text, size_t *byteLength, size_t *length ) {
+	int offset = static_cast<int>( reinterpret_cast<size_t>(text) & 15 );
+	const __m128i *block = reinterpret_cast<const __m128i *>( text - offset );
+	const __m128i zero = _mm_setzero_si128();
+	int valid = ( 0xFFFF << offset ) & 0xFFFF;
+	size_t len = 0;
+	for(;;) {
+		__m128i data = _mm_load_si128( block );
+		int zeros = _mm_movemask_epi8( _mm_cmpeq_epi8( data, zero ) ) & valid;
+		int starts = StartBytes( data ) & valid;
+		if ( zeros ) {
+			int end = FirstBit( zeros );
+			*length = len + BitCount16( starts & ( (1 << end) - 1 ) );
+			*byteLength = static_cast<size_t>( reinterpret_cast<const char *>(block) + end - text );
+			return;
+		}
+		len += BitCount16( starts );
+		valid = 0xFFFF;
+		block++;
+	}
+}
+
+/*
+================
+CountLengthSSE2
+================
+*/
+static int CountLengthSSE2( const char *text, int byteLen ) {
+	int len = 0;
+	int i = 0;
+	for( ; i + 16 <= byteLen; i += 16 )
+		len += BitCount16( StartBytes( _mm_loadu_si128( reinterpret_cast<const __m128i *>(text + i) ) ) );
+	for( ; i < byteLen; i++ ) {
+		if( (text[i] & MASK2BIT) != MASK1BIT )
+			len++;
+	}
+	return len;
+}
+
+/*
+================
+FindByteSSE2
+
+Returns a pointer to the first c or the terminator
+================
+*/
+static const char *FindByteSSE2( const char *text, char c ) {
+	int offset = static_cast<int>( reinterpret_cast<size_t>(text) & 15 );
+	const __m128i *block = reinterpret_cast<const __m128i *>( text - offset );
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i find = _mm_set1_epi8( c );
+	int valid = ( 0xFFFF << offset ) & 0xFFFF;
+	for(;;) {
+		__m128i data = _mm_load_si128( block );
+		int found = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( data, zero ), _mm_cmpeq_epi8( data, find ) ) ) & valid;
+		if ( found )
+			return reinterpret_cast<const char *>(block) + FirstBit( found );
+		valid = 0xFFFF;
+		block++;
+	}
+}
+
+/*
+================
+ToLowerAscii
+================
+*/
+OG_INLINE __m128i ToLowerAscii( __m128i data ) {
+	__m128i upper = _mm_and_si128( _mm_cmpgt_epi8( data, _mm_set1_epi8( 'A' - 1 ) ), _mm_cmplt_epi8( data, _mm_set1_epi8( 'Z' + 1 ) ) );
+	return _mm_or_si128( data, _mm_and_si128( upper, _mm_set1_epi8( 0x20 ) ) );
+}
+
+/*
+================
+IcmpAsciiPrefixSSE2
+
+Returns how many leading bytes are equal ascii characters ignoring case,
+so the comparison can continue there on a character boundary
+================
+*/
+static int IcmpAsciiPrefixSSE2( const char *text1, const char *text2 ) {
+	const __m128i zero = _mm_setzero_si128();
+	int i = 0;
+	while( CanLoad16( text1 + i ) && CanLoad16( text2 + i ) ) {
+		__m128i a = ToLowerAscii( _mm_loadu_si128( reinterpret_cast<const __m128i *>(text1 + i) ) );
+		__m128i b = ToLowerAscii( _mm_loadu_si128( reinterpret_cast<const __m128i *>(text2 + i) ) );
+
+		// stop at a difference, the terminator or a non-ascii character
+		int stop = _mm_movemask_epi8( _mm_cmpeq_epi8( a, b ) ) ^ 0xFFFF;
+		stop |= _mm_movemask_epi8( _mm_cmpeq_epi8( a, zero ) );
+		stop |= _mm_movemask_epi8( a );
+		if ( stop )
+			return i + FirstBit( stop );
+		i += 16;
+	}
+	return i;
+}
+
+#endif
+
+/*
+================
+CountLength
+================
+*/
+static int CountLength( const char *text, int byteLen ) {
+#if OG_STRING_SSE2
+	if ( UseSSE2() )
+		return CountLengthSSE2( text, byteLen );
+#endif
+	int len = 0;
+	for( int i=0; i<byteLen; i++ ) {
+		if( (text[i] & MASK2BIT) != MASK1BIT )
+			len++;
+	}
+	return len;
+}
+
+/*
+================
+FindByte
+
+Returns a pointer to the first c or the terminator
+================
+*/
+static const char *FindByte( const char *text, char c ) {
+#if OG_STRING_SSE2
+	if ( UseSSE2() )
+		return FindByteSSE2( text, c );
+#endif
+	while( *text != '\0' && *text != c )
+		text++;
+	return text;
+}
+
+/*
+================
+MatchNoCase
+================
+*/
+static bool MatchNoCase( const char *text, int byteLen, const char *find, int findByteLen ) {
+	int numB1, numB2;
+	for( int i=0, j=0; j<findByteLen; i += numB1, j += numB2 ) {
+		if ( i >= byteLen || Utf8ToLowerWide( text+i, &numB1 ) != Utf8ToLowerWide( find+j, &numB2 ) )
+			return false;
+	}
+	return true;
+}
+
 /*
 ==============================================================================
 
@@ -221,18 +471,26 @@ String::String
 ================
 */
 String::String() {
+	allocator = NULL;
 	Init();
 }
 String::String( const char *text ) {
+	allocator = NULL;
 	Init();
 	size_t byteLen, len;
 	BothLengths( text, &byteLen, &len );
 	SetData( text, byteLen, len );
 }
 String::String( const String &str ) {
+	allocator = NULL;
 	Init();
 	SetData( str.data, str.byteLength, str.length );
 }
+String::String( const StringView &view ) {
+	allocator = NULL;
+	Init();
+	*this = view;
+}
 
 /*
 ================
@@ -253,6 +511,45 @@ void String::Clear( void ) {
 	Init();
 }
 
+/*
+================
+String::MoveTo
+================
+*/
+void String::MoveTo( String &other ) {
+	if ( &other == this )
+		return;
+
+	// memory from another allocator can't be handed over
+	if ( data != hardBuffer && other.allocator != allocator ) {
+		other.SetData( data, byteLength, length );
+		Clear();
+		return;
+	}
+
+	other.Free();
+	if ( data == hardBuffer ) {
+		memcpy( other.hardBuffer, hardBuffer, byteLength + 1 );
+		other.data = other.hardBuffer;
+	} else
+		other.data = data;
+	other.size = size;
+	other.length = length;
+	other.byteLength = byteLength;
+	Init();
+}
+
+/*
+================
+String::SetAllocator
+================
+*/
+void String::SetAllocator( MemoryAllocator *_allocator ) {
+	Free();
+	allocator = _allocator;
+	Init();
+}
+
 /*
 ================
 String::Init
@@ -273,9 +570,14 @@ String::Resize
 */
 void String::Resize( int newSize, bool keepContent ) {
 	OG_ASSERT( newSize > 0 );
-	size = static_cast<int>( ceil( static_cast<float>(newSize)/static_cast<float>(GRANULARITY) ) ) * GRANULARITY;
+	int oldSize = size;
+
+	// grow by half when appending, so a string built piece by piece doesn't reallocate every time
+	if ( keepContent && newSize < size + size / 2 )
+		newSize = size + size / 2;
+	size = ( ( newSize + GRANULARITY - 1 ) / GRANULARITY ) * GRANULARITY;
 
-	char *newData = new char[ size ];
+	char *newData = static_cast<char *>( MemAlloc( allocator, size ) );
 
 	if ( data ) {
 		if ( keepContent )
@@ -285,7 +587,7 @@ void String::Resize( int newSize, bool keepContent ) {
 			byteLength = 0;
 		}
 		if ( data != hardBuffer )
-			delete[] data;
+			MemFree( allocator, data, oldSize );
 	}
 	data = newData;
 }
@@ -396,19 +698,50 @@ String::Find
 ================
 */
 int String::Find( const char *str, const char *text, bool caseSensitive, int start ) {
-	int findLen = Length(text);
+	int i = start > 0 ? countBytesForLength( str, start, 0 ) : 0;
+	if ( text[0] == '\0' )
+		return str[i] != '\0' ? i : INVALID_POSITION;
+
 	if ( caseSensitive ) {
-		for( int i=0; str[i] != 0; i++ ) {
-			if ( Cmpn(str+i, text, findLen ) == 0 )
-				return i;
+		// jump from one occurence of the first byte to the next
+		size_t findByteLen = ByteLength( text );
+		for( const char *pos = FindByte( str+i, text[0] ); *pos != '\0'; pos = FindByte( pos+1, text[0] ) ) {
+			if ( strncmp( pos, text, findByteLen ) == 0 )
+				return static_cast<int>( pos - str );
 		}
 	} else {
-		for( int i=0; str[i] != 0; i++ ) {
+		int findLen = Length(text);
+		for( ; str[i] != 0; i++ ) {
 			if ( Icmpn(str+i, text, findLen ) == 0 )
 				return i;
 		}
 	}
-	return -1;
+	return INVALID_POSITION;
+}
+int String::Find( const StringView &text, bool caseSensitive, int start ) const {
+	const char *find = text.GetData();
+	int findByteLen = text.ByteLength();
+	int i = start > 0 ? countBytesForLength( data, start, byteLength ) : 0;
+	if ( findByteLen == 0 )
+		return i;
+
+	if ( caseSensitive ) {
+		// jump from one occurence of the first byte to the next
+		const char *pos;
+		for( ; i <= byteLength - findByteLen; i = static_cast<int>( pos - data ) + 1 ) {
+			pos = static_cast<const char *>( memchr( data+i, find[0], byteLength - findByteLen - i + 1 ) );
+			if ( pos == NULL )
+				break;
+			if ( memcmp( pos, find, findByteLen ) == 0 )
+				return static_cast<int>( pos - data );
+		}
+	} else {
+		for( ; i < byteLength; i++ ) {
+			if ( (data[i] & MASK2BIT) != MASK1BIT && MatchNoCase( data+i, byteLength-i, find, findByteLen ) )
+				return i;
+		}
+	}
+	return INVALID_POSITION;
 }
 
 /*
@@ -417,7 +750,42 @@ String::FindOneOf
 ================
 */
 int String::FindOneOf( const char *str, const char *text, bool caseSensitive, int start ) {
-	return -1;
+	// ascii characters are looked up in a table, others get compared one by one
+	bool asciiSet[128];
+	memset( asciiSet, 0, sizeof(asciiSet) );
+	bool hasWide = false;
+	for( int j=0; text[j] != '\0'; j++ ) {
+		if ( text[j] & MASK1BIT )
+			hasWide = true;
+		else if ( caseSensitive )
+			asciiSet[static_cast<int>(text[j])] = true;
+		else {
+			asciiSet[tolower( text[j] )] = true;
+			asciiSet[toupper( text[j] )] = true;
+		}
+	}
+
+	int numBytes;
+	for( int i = start > 0 ? countBytesForLength( str, start, 0 ) : 0; str[i] != '\0'; i += numBytes ) {
+		if ( !(str[i] & MASK1BIT) ) {
+			numBytes = 1;
+			if ( asciiSet[static_cast<int>(str[i])] )
+				return i;
+		} else {
+			wchar_t ch = Utf8ToWChar( str+i, &numBytes );
+			if ( !hasWide )
+				continue;
+			if ( !caseSensitive )
+				ch = static_cast<wchar_t>( towlower( ch ) );
+			int findBytes;
+			for( int j=0; text[j] != '\0'; j += findBytes ) {
+				wchar_t findCh = Utf8ToWChar( text+j, &findBytes );
+				if ( ( caseSensitive ? findCh : static_cast<wchar_t>( towlower( findCh ) ) ) == ch )
+					return i;
+			}
+		}
+	}
+	return INVALID_POSITION;
 }
 
 /*
@@ -468,7 +836,8 @@ int String::Replace( const char *a, const char *b, int start ) {
 			int oldLength = length;
 			int oldSize = size;
 			if ( data == hardBuffer ) {
-				oldData = new char[byteLength+1];
+				oldSize = byteLength+1;
+				oldData = static_cast<char *>( MemAlloc( allocator, oldSize ) );
 				memcpy( oldData, data, byteLength+1 );
 			} else {
 				oldData = data;
@@ -494,7 +863,7 @@ int String::Replace( const char *a, const char *b, int start ) {
 			data[byteLength] = '\0';
 			length = oldLength + (Length(b) - Length(a)) * count;
 
-			delete[] oldData;
+			MemFree( allocator, oldData, oldSize );
 		}
 		return count;
 	}
@@ -933,6 +1302,17 @@ int String::Cmp( const char *text1, const char *text2 ) {
 
 	return 0;
 }
+int String::Cmp( const StringView &text ) const {
+	const char *text2 = text.GetData();
+	int byteLength2 = text.ByteLength();
+	int d;
+	for( int i=0; i<byteLength || i<byteLength2; i++ ) {
+		d = ( i < byteLength ? data[i] : 0 ) - ( i < byteLength2 ? text2[i] : 0 );
+		if ( d != 0 )
+			return d;
+	}
+	return 0;
+}
 
 /*
 ================
@@ -994,14 +1374,36 @@ int String::Icmp( const char *text1, const char *text2 ) {
 	else if ( text2 == NULL )
 		return 1;
 
+	int start = 0;
+#if OG_STRING_SSE2
+	if ( UseSSE2() )
+		start = IcmpAsciiPrefixSSE2( text1, text2 );
+#endif
+
 	int numB1, numB2, d;
-	for( int i=0,j=0; text1[i] || text2[i]; i += numB1, j += numB2 ) {
+	for( int i=start,j=start; text1[i] || text2[j]; i += numB1, j += numB2 ) {
 		d = Utf8ToLowerWide( text1+i, &numB1 ) - Utf8ToLowerWide( text2+j, &numB2 );
 		if ( d != 0 )
 			return d;
 	}
 	return 0;
 }
+int String::Icmp( const StringView &text ) const {
+	const char *text2 = text.GetData();
+	int byteLength2 = text.ByteLength();
+	int numB1, numB2, d;
+	int i=0, j=0;
+	for( ; i<byteLength && j<byteLength2; i += numB1, j += numB2 ) {
+		d = Utf8ToLowerWide( data+i, &numB1 ) - Utf8ToLowerWide( text2+j, &numB2 );
+		if ( d != 0 )
+			return d;
+	}
+	if ( i < byteLength )
+		return 1;
+	if ( j < byteLength2 )
+		return -1;
+	return 0;
+}
 
 /*
 ================
@@ -1057,12 +1459,9 @@ size_t String::Length( const char *text ) {
 	if ( !text ) // users could send a NULL string (no point in getting to loop if it is NULL)
 		return 0;
 
-	size_t pos = 0;
-	for( int i=0; text[i] != '\0'; i++ ) {
-		if( (text[i] & MASK2BIT) != MASK1BIT )
-			pos++;
-	}
-	return pos;
+	size_t byteLen, len;
+	BothLengths( text, &byteLen, &len );
+	return len;
 }
 
 /*
@@ -1074,9 +1473,7 @@ size_t String::ByteLength( const char *text ) {
 	if ( !text ) // users could send a NULL string (no point in getting to loop if it is NULL)
 		return 0;
 
-	size_t i;
-	for ( i = 0; text[i] != '\0'; i++ );
-	return i;
+	return strlen( text );
 }
 
 /*
@@ -1090,6 +1487,12 @@ void String::BothLengths( const char *text, size_t *byteLength, size_t *length )
 	if ( !text ) // users could send a NULL string (no point in getting to loop if it is NULL)
 		return;
 
+#if OG_STRING_SSE2
+	if ( UseSSE2() ) {
+		BothLengthsSSE2( text, byteLength, length );
+		return;
+	}
+#endif
 	for( ; text[*byteLength] != '\0'; (*byteLength)++ ) {
 		if( (text[*byteLength] & MASK2BIT) != MASK1BIT )
 			(*length)++;
@@ -1122,28 +1525,27 @@ String::StripEscapeColor
 ================
 */
 size_t String::StripEscapeColor( char *str ) {
-	uInt escapeLength, numRemoved = 0;
-	int skip=0;
 	char *writePos = str;
-	char *readPos = str;
-	while( *readPos != '\0' ) {
-		if ( skip ) {
-			skip--;
-			numRemoved++;
-		} else {
-			escapeLength = GetEscapeColorLength( readPos );
-			if ( escapeLength ) {
-				skip = escapeLength-1;
-				numRemoved += escapeLength;
-			} else {
-				writePos[0] = readPos[0];
-				writePos++;
-			}
-		}
-		readPos++;
+	const char *readPos = str;
+	for(;;) {
+		// copy everything up to the next '^' at once
+		const char *escape = FindByte( readPos, '^' );
+		size_t run = escape - readPos;
+		if ( writePos != readPos )
+			memmove( writePos, readPos, run );
+		writePos += run;
+		readPos = escape;
+		if ( *readPos == '\0' )
+			break;
+
+		int escapeLength = GetEscapeColorLength( readPos );
+		if ( escapeLength )
+			readPos += escapeLength;
+		else
+			*writePos++ = *readPos++;
 	}
 	*writePos = '\0';
-	return numRemoved;
+	return static_cast<size_t>( readPos - writePos );
 }
 
 /*
@@ -1173,13 +1575,24 @@ void String::SetData( const char *text, int byteLen, int len ) {
 		return;
 	}
 
+	// text may point into our own buffer ( it's big enough then, so CheckSize won't reallocate )
 	CheckSize( byteLen + 1, false );
-	memcpy( data, text, byteLen );
-	data[len] = '\0';
+	memmove( data, text, byteLen );
+	data[byteLen] = '\0';
 	byteLength = byteLen;
 	length = len;
 }
 
+/*
+================
+String::operator=
+================
+*/
+String &String::operator=( const StringView &view ) {
+	SetData( view.GetData(), view.ByteLength(), CountLength( view.GetData(), view.ByteLength() ) );
+	return *this;
+}
+
 /*
 ================
 String::ReadFromFile